@@ -1,5 +1,34 @@
 #include "Collider.h"
 
+#include <cmath>
+#include <algorithm>
+
+bool AABB::Contains(const AABB& other) const
+{
+    return min.x <= other.min.x && min.y <= other.min.y && max.x >= other.max.x && max.y >= other.max.y;
+}
+
+bool AABB::Contains(Vec2 point) const
+{
+    return point.x >= min.x && point.y >= min.y && point.x <= max.x && point.y <= max.y;
+}
+
+float AABB::Perimeter() const
+{
+    return 2.0f * ((max.x - min.x) + (max.y - min.y));
+}
+
+AABB AABB::Expanded(float margin) const
+{
+    return { min - Vec2(margin, margin), max + Vec2(margin, margin) };
+}
+
+AABB AABB::Union(const AABB& a, const AABB& b)
+{
+    return { Vec2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+             Vec2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)) };
+}
+
 Collider::Collider()
 {
 
@@ -10,6 +39,76 @@ Collider::Collider(std::vector<Vec2> points)
     Points = points;
 }
 
+void Collider::BakeLocalPoints()
+{
+    if (Points.empty())
+        return;
+
+    Vec2 centroid;
+    for (const Vec2 &point : Points)
+        centroid = centroid + point;
+    centroid = centroid / static_cast<float>(Points.size());
+
+    LocalPoints.clear();
+    for (const Vec2 &point : Points)
+        LocalPoints.push_back(point - centroid);
+
+    Position = centroid;
+    Rotation = 0.0f;
+}
+
+void Collider::SetTransform(Vec2 position, float rotation)
+{
+    Position = position;
+    Rotation = rotation;
+
+    float rotation_rad = rotation * (static_cast<float>(M_PI) / 180.0f);
+    float cosR = std::cos(rotation_rad);
+    float sinR = std::sin(rotation_rad);
+
+    Points.resize(LocalPoints.size());
+    for (size_t i = 0; i < LocalPoints.size(); i++)
+    {
+        const Vec2 &local = LocalPoints[i];
+        Points[i] = Vec2(position.x + local.x * cosR - local.y * sinR,
+                         position.y + local.x * sinR + local.y * cosR);
+    }
+}
+
+AABB Collider::GetBounds() const
+{
+    if (Points.empty())
+        return { Position, Position };
+
+    AABB bounds = { Points[0], Points[0] };
+    for (const Vec2 &point : Points)
+    {
+        bounds.min = Vec2(std::min(bounds.min.x, point.x), std::min(bounds.min.y, point.y));
+        bounds.max = Vec2(std::max(bounds.max.x, point.x), std::max(bounds.max.y, point.y));
+    }
+    return bounds;
+}
+
+bool Collider::Contains(Vec2 point) const
+{
+    // Even-odd rule; open polylines have no inside.
+    if (!Loop || Points.size() < 3)
+        return false;
+
+    bool inside = false;
+    for (size_t i = 0, j = Points.size() - 1; i < Points.size(); j = i++)
+    {
+        const Vec2 &a = Points[i];
+        const Vec2 &b = Points[j];
+        if ((a.y > point.y) != (b.y > point.y) &&
+            point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
 Collider Collider::Rectangle(float x, float y, float w, float h)
 {
     std::vector<Vec2> points; 
@@ -4,6 +4,19 @@
 #include <vector>
 #include "Vec2.h"
 
+struct AABB
+{
+    Vec2 min;
+    Vec2 max;
+
+    bool Contains(const AABB& other) const;
+    bool Contains(Vec2 point) const;
+    float Perimeter() const;
+    AABB Expanded(float margin) const;
+
+    static AABB Union(const AABB& a, const AABB& b);
+};
+
 class Collider
 {
     public:
@@ -12,8 +25,20 @@ class Collider
         bool IsInvisible = false;
         bool Loop = true;
 
+        // Points relative to Position, rotated by Rotation (degrees) to produce Points.
+        std::vector<Vec2> LocalPoints;
+        Vec2 Position = Vec2();
+        float Rotation = 0.0f;
+
         Collider();
         Collider(std::vector<Vec2> points);
 
+        // Moves the pivot to the centroid of Points and stores them relative to it.
+        void BakeLocalPoints();
+        void SetTransform(Vec2 position, float rotation);
+
+        AABB GetBounds() const;
+        bool Contains(Vec2 point) const;
+
         static Collider Rectangle(float x, float y, float w, float h);
 };
\ No newline at end of file
@@ -0,0 +1,458 @@
+#include "ColliderWorld.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    // A handle is the slot index in the low bits and the slot's generation above it.
+    // The generation wraps within the remaining bits so handles stay positive.
+    const int slotBits = 20;
+    const int slotMask = (1 << slotBits) - 1;
+    const int generationMask = (1 << (31 - slotBits)) - 1;
+}
+
+ColliderWorld::ColliderWorld()
+{
+
+}
+
+int ColliderWorld::Add(const Collider& collider)
+{
+    int index;
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        index = static_cast<int>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot &slot = slots[index];
+    slot.collider = collider;
+    slot.alive = true;
+    if (slot.collider.LocalPoints.empty())
+        slot.collider.BakeLocalPoints();
+
+    int leaf = AllocateNode();
+    nodes[leaf].slot = index;
+    nodes[leaf].bounds = slot.collider.GetBounds().Expanded(BoundsMargin);
+    slot.leaf = leaf;
+
+    // Cost added by the insert itself is the tree's new baseline, not degradation.
+    float costBefore = treeCost;
+    InsertLeaf(leaf);
+    builtCost += treeCost - costBefore;
+    aliveCount++;
+
+    return HandleAt(index);
+}
+
+void ColliderWorld::Remove(int handle)
+{
+    int index = FindSlot(handle);
+    if (index == -1)
+        return;
+
+    Slot &slot = slots[index];
+    float costBefore = treeCost;
+    RemoveLeaf(slot.leaf);
+    FreeNode(slot.leaf);
+    builtCost += treeCost - costBefore;
+
+    slot.leaf = -1;
+    slot.alive = false;
+    // Invalidates every handle still pointing at this slot.
+    slot.generation = (slot.generation + 1) & generationMask;
+    slot.collider = Collider();
+    freeSlots.push_back(index);
+    aliveCount--;
+}
+
+void ColliderWorld::SetTransform(int handle, Vec2 position, float rotation)
+{
+    int index = FindSlot(handle);
+    if (index == -1)
+        return;
+
+    Collider* collider = &slots[index].collider;
+    collider->SetTransform(position, rotation);
+
+    // Still inside the padded leaf: the tree stays valid as it is.
+    int leaf = slots[index].leaf;
+    AABB bounds = collider->GetBounds();
+    if (nodes[leaf].bounds.Contains(bounds))
+        return;
+
+    nodes[leaf].bounds = bounds.Expanded(BoundsMargin);
+    Refit(nodes[leaf].parent);
+    CheckQuality();
+}
+
+Collider* ColliderWorld::Get(int handle)
+{
+    int index = FindSlot(handle);
+    return index == -1 ? nullptr : &slots[index].collider;
+}
+
+const Collider* ColliderWorld::Get(int handle) const
+{
+    int index = FindSlot(handle);
+    return index == -1 ? nullptr : &slots[index].collider;
+}
+
+int ColliderWorld::SlotCount() const
+{
+    return static_cast<int>(slots.size());
+}
+
+int ColliderWorld::HandleAt(int slot) const
+{
+    if (slot < 0 || slot >= static_cast<int>(slots.size()) || !slots[slot].alive)
+        return -1;
+    return (slots[slot].generation << slotBits) | slot;
+}
+
+int ColliderWorld::Count() const
+{
+    return aliveCount;
+}
+
+int ColliderWorld::Pick(Vec2 point) const
+{
+    int picked = -1;
+    if (root == -1)
+        return -1;
+
+    std::vector<int> stack;
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!node.bounds.Contains(point))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            const Collider &collider = slots[node.slot].collider;
+            // Higher slots are drawn on top, so they win.
+            if (!collider.IsInvisible && collider.Contains(point) && node.slot > picked)
+                picked = node.slot;
+            continue;
+        }
+
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+
+    return HandleAt(picked);
+}
+
+bool ColliderWorld::Raycast(const Ray& ray, RayHit& hitInfo) const
+{
+    bool hitSomething = false;
+    float closestDistance = ray.maxDistance;
+    RayHit tempHit;
+
+    hitInfo.hit = false;
+    if (root == -1)
+        return false;
+
+    // Every boid casts several rays per tick, so the traversal stack is reused per thread instead of allocated per ray.
+    thread_local std::vector<int> stack;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+
+        // Anything farther than the closest hit so far can be skipped.
+        if (!IntersectsRay(node.bounds, ray, closestDistance))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (Physics2D::GetColliderIntersection(slots[node.slot].collider, ray, tempHit) && tempHit.distance < closestDistance)
+            {
+                closestDistance = tempHit.distance;
+                hitInfo = tempHit;
+                hitSomething = true;
+            }
+            continue;
+        }
+
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+
+    return hitSomething;
+}
+
+void ColliderWorld::Rebuild()
+{
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+    treeCost = 0.0f;
+
+    std::vector<int> leaves;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        Slot &slot = slots[i];
+        if (!slot.alive)
+            continue;
+
+        int leaf = AllocateNode();
+        nodes[leaf].slot = static_cast<int>(i);
+        nodes[leaf].bounds = slot.collider.GetBounds().Expanded(BoundsMargin);
+        slot.leaf = leaf;
+        leaves.push_back(leaf);
+    }
+
+    if (!leaves.empty())
+    {
+        root = BuildRange(leaves, 0, static_cast<int>(leaves.size()));
+        nodes[root].parent = -1;
+    }
+
+    builtCost = treeCost;
+    rebuildCount++;
+}
+
+int ColliderWorld::RebuildCount() const
+{
+    return rebuildCount;
+}
+
+int ColliderWorld::FindSlot(int handle) const
+{
+    if (handle < 0)
+        return -1;
+
+    int index = handle & slotMask;
+    if (index >= static_cast<int>(slots.size()) || !slots[index].alive || slots[index].generation != handle >> slotBits)
+        return -1;
+    return index;
+}
+
+int ColliderWorld::AllocateNode()
+{
+    if (!freeNodes.empty())
+    {
+        int node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node] = Node();
+        return node;
+    }
+
+    nodes.emplace_back();
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+void ColliderWorld::FreeNode(int node)
+{
+    if (!nodes[node].IsLeaf())
+        treeCost -= nodes[node].bounds.Perimeter();
+    freeNodes.push_back(node);
+}
+
+void ColliderWorld::SetNodeBounds(int node, const AABB& bounds)
+{
+    Node &n = nodes[node];
+    treeCost += bounds.Perimeter() - n.bounds.Perimeter();
+    n.bounds = bounds;
+}
+
+// Standard dynamic AABB tree insertion: walk down towards the sibling that grows the tree
+// the least, then splice a new parent in above it.
+void ColliderWorld::InsertLeaf(int leaf)
+{
+    if (root == -1)
+    {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    const AABB leafBounds = nodes[leaf].bounds;
+    int sibling = root;
+    while (!nodes[sibling].IsLeaf())
+    {
+        const Node &node = nodes[sibling];
+        float combined = AABB::Union(node.bounds, leafBounds).Perimeter();
+
+        // Cost of making a new parent for this node and the leaf.
+        float cost = 2.0f * combined;
+        // Minimum cost of pushing the leaf further down the tree.
+        float inheritance = 2.0f * (combined - node.bounds.Perimeter());
+
+        float costLeft = AABB::Union(nodes[node.left].bounds, leafBounds).Perimeter() + inheritance;
+        if (!nodes[node.left].IsLeaf())
+            costLeft -= nodes[node.left].bounds.Perimeter();
+
+        float costRight = AABB::Union(nodes[node.right].bounds, leafBounds).Perimeter() + inheritance;
+        if (!nodes[node.right].IsLeaf())
+            costRight -= nodes[node.right].bounds.Perimeter();
+
+        if (cost < costLeft && cost < costRight)
+            break;
+
+        sibling = costLeft < costRight ? node.left : node.right;
+    }
+
+    int oldParent = nodes[sibling].parent;
+    int newParent = AllocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[newParent].bounds = AABB::Union(nodes[sibling].bounds, leafBounds);
+    treeCost += nodes[newParent].bounds.Perimeter();
+
+    if (oldParent == -1)
+        root = newParent;
+    else if (nodes[oldParent].left == sibling)
+        nodes[oldParent].left = newParent;
+    else
+        nodes[oldParent].right = newParent;
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    Refit(oldParent);
+}
+
+void ColliderWorld::RemoveLeaf(int leaf)
+{
+    if (leaf == root)
+    {
+        root = -1;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    // The sibling takes the parent's place.
+    if (grandParent == -1)
+    {
+        root = sibling;
+        nodes[sibling].parent = -1;
+    }
+    else
+    {
+        if (nodes[grandParent].left == parent)
+            nodes[grandParent].left = sibling;
+        else
+            nodes[grandParent].right = sibling;
+        nodes[sibling].parent = grandParent;
+    }
+
+    FreeNode(parent);
+    Refit(grandParent);
+}
+
+// Recomputes bounds from node up to the root, stopping as soon as a node is unchanged.
+void ColliderWorld::Refit(int node)
+{
+    while (node != -1)
+    {
+        Node &n = nodes[node];
+        AABB bounds = AABB::Union(nodes[n.left].bounds, nodes[n.right].bounds);
+        if (bounds.Contains(n.bounds) && n.bounds.Contains(bounds))
+            break;
+
+        SetNodeBounds(node, bounds);
+        node = n.parent;
+    }
+}
+
+// Top-down median split along the longest axis of the centroids.
+int ColliderWorld::BuildRange(std::vector<int>& leaves, int begin, int end)
+{
+    if (end - begin == 1)
+        return leaves[begin];
+
+    AABB centroids = { nodes[leaves[begin]].bounds.min, nodes[leaves[begin]].bounds.min };
+    for (int i = begin; i < end; i++)
+    {
+        const AABB &bounds = nodes[leaves[i]].bounds;
+        Vec2 center = (bounds.min + bounds.max) / 2.0f;
+        centroids = AABB::Union(centroids, { center, center });
+    }
+
+    bool splitX = (centroids.max.x - centroids.min.x) >= (centroids.max.y - centroids.min.y);
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end, [&](int a, int b)
+    {
+        const AABB &ba = nodes[a].bounds;
+        const AABB &bb = nodes[b].bounds;
+        return splitX ? ba.min.x + ba.max.x < bb.min.x + bb.max.x
+                      : ba.min.y + ba.max.y < bb.min.y + bb.max.y;
+    });
+
+    int left = BuildRange(leaves, begin, mid);
+    int right = BuildRange(leaves, mid, end);
+
+    int node = AllocateNode();
+    nodes[node].left = left;
+    nodes[node].right = right;
+    nodes[node].bounds = AABB::Union(nodes[left].bounds, nodes[right].bounds);
+    nodes[left].parent = node;
+    nodes[right].parent = node;
+    treeCost += nodes[node].bounds.Perimeter();
+
+    return node;
+}
+
+void ColliderWorld::CheckQuality()
+{
+    // With fewer than three leaves there is only one possible tree, so a rebuild can't improve it.
+    if (aliveCount < 3)
+        return;
+
+    // builtCost follows inserts and removals, so only growth from refitting moved colliders counts.
+    if (treeCost > builtCost * RebuildThreshold)
+        Rebuild();
+}
+
+bool ColliderWorld::IntersectsRay(const AABB& bounds, const Ray& ray, float maxDistance)
+{
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+
+    const float origin[2] = { ray.origin.x, ray.origin.y };
+    const float direction[2] = { ray.direction.x, ray.direction.y };
+    const float lo[2] = { bounds.min.x, bounds.min.y };
+    const float hi[2] = { bounds.max.x, bounds.max.y };
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (std::fabs(direction[axis]) < 1e-8f)
+        {
+            // Parallel to this slab: either always inside it or never.
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis])
+                return false;
+            continue;
+        }
+
+        float inv = 1.0f / direction[axis];
+        float t0 = (lo[axis] - origin[axis]) * inv;
+        float t1 = (hi[axis] - origin[axis]) * inv;
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+            return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "Vec2.h"
+#include "Collider.h"
+#include "Physics2D.h"
+
+// Owns a set of colliders that can be added, removed and moved at runtime.
+// Raycasts go through a dynamic AABB tree. Moving a collider refits only its own leaf
+// and the ancestors whose bounds actually change. The tree is only rebuilt when its
+// quality has drifted too far from the last full build.
+class ColliderWorld
+{
+    public:
+        // Leaves are padded by this much so small moves don't touch the tree at all.
+        float BoundsMargin = 4.0f;
+        // Rebuild once moves have grown the summed node perimeter past this multiple of its value
+        // after the last build, adjusted for the colliders added and removed since.
+        float RebuildThreshold = 1.5f;
+
+        ColliderWorld();
+
+        int Add(const Collider& collider);
+        void Remove(int handle);
+        void SetTransform(int handle, Vec2 position, float rotation);
+
+        // Returns nullptr for handles that were removed or never existed.
+        // Handles carry the slot's generation, so a stale handle never resolves to a collider added later in the same slot.
+        Collider* Get(int handle);
+        const Collider* Get(int handle) const;
+
+        // Iterate slots in [0, SlotCount()) and use HandleAt() to get each live collider's handle (-1 for free slots).
+        int SlotCount() const;
+        int HandleAt(int slot) const;
+        int Count() const;
+
+        // Topmost visible collider containing point, or -1.
+        int Pick(Vec2 point) const;
+
+        bool Raycast(const Ray& ray, RayHit& hitInfo) const;
+
+        void Rebuild();
+        int RebuildCount() const;
+
+    private:
+        struct Node
+        {
+            AABB bounds;
+            int parent = -1;
+            int left = -1;
+            int right = -1;
+            int slot = -1;
+
+            bool IsLeaf() const { return left == -1; }
+        };
+
+        struct Slot
+        {
+            Collider collider;
+            int leaf = -1;
+            int generation = 0;
+            bool alive = false;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<int> freeNodes;
+        int root = -1;
+
+        std::vector<Slot> slots;
+        std::vector<int> freeSlots;
+        int aliveCount = 0;
+
+        // Sum of internal node perimeters, kept up to date as nodes change.
+        float treeCost = 0.0f;
+        // treeCost after the last build plus what inserts and removals have changed since.
+        float builtCost = 0.0f;
+        int rebuildCount = 0;
+
+        int FindSlot(int handle) const;
+
+        int AllocateNode();
+        void FreeNode(int node);
+        void SetNodeBounds(int node, const AABB& bounds);
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+        void Refit(int node);
+        int BuildRange(std::vector<int>& leaves, int begin, int end);
+        void CheckQuality();
+
+        static bool IntersectsRay(const AABB& bounds, const Ray& ray, float maxDistance);
+};
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "CompactFlock.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+    const double headingSteps = 65536.0;
+    const double speedSteps = 65535.0;
+    const double twoPi = 2.0 * M_PI;
+
+    // Distance along one axis of a wrapping world.
+    float WrappedDelta(float a, float b, float extent)
+    {
+        float d = std::fabs(a - b);
+        return std::min(d, extent - d);
+    }
+
+    void AddMetrics(MetricMeans& sum, const FlockMetrics& metrics)
+    {
+        sum.flockCount += metrics.flockCount;
+        sum.largestFlockFraction += metrics.boidCount > 0 ? static_cast<float>(metrics.largestFlock) / metrics.boidCount : 0.0f;
+        sum.polarization += metrics.polarization;
+        sum.nearestNeighborDistance += metrics.meanNearestNeighborDistance;
+    }
+
+    void DivideMetrics(MetricMeans& sum, int count)
+    {
+        if (count <= 0)
+            return;
+        sum.flockCount /= count;
+        sum.largestFlockFraction /= count;
+        sum.polarization /= count;
+        sum.nearestNeighborDistance /= count;
+    }
+}
+
+template<typename Coord>
+CompactFlock<Coord>::CompactFlock() : rng(std::random_device{}())
+{
+
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::Seed(unsigned int seed)
+{
+    rng.seed(seed);
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::CreateRandomBoids(size_t count)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> x(0, Settings.worldWidth);
+    std::uniform_real_distribution<float> y(0, Settings.worldHeight);
+
+    Boids.reserve(Boids.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vec2 position = Vec2(x(rng), y(rng));
+        Vec2 velocity = Vec2(unit(rng), unit(rng));
+        velocity.Normalize();
+        Boids.push_back(Encode(position, velocity));
+    }
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::Pack(const Flock& flock)
+{
+    Settings = flock.Settings;
+    // The packed kernel only gathers metric neighbors.
+    Settings.neighborMode = NeighborMode::Metric;
+    Colliders = flock.Colliders;
+
+    Boids.clear();
+    Boids.reserve(flock.Boids.size());
+    for (const Boid &boid : flock.Boids)
+        Boids.push_back(Encode(boid.position, boid.velocity));
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::Unpack(Flock& flock) const
+{
+    flock.Boids.resize(Boids.size());
+    for (size_t i = 0; i < Boids.size(); i++)
+    {
+        Boid &boid = flock.Boids[i];
+        boid.id = static_cast<int>(i);
+        boid.position = DecodePosition(Boids[i]);
+        boid.velocity = DecodeVelocity(Boids[i]);
+        boid.desiredDirection = boid.velocity;
+    }
+}
+
+template<typename Coord>
+PackedBoid<Coord> CompactFlock<Coord>::Encode(Vec2 position, Vec2 velocity) const
+{
+    const double coordMax = static_cast<double>(std::numeric_limits<Coord>::max());
+
+    double x = std::clamp(static_cast<double>(position.x) / Settings.worldWidth, 0.0, 1.0);
+    double y = std::clamp(static_cast<double>(position.y) / Settings.worldHeight, 0.0, 1.0);
+
+    double angle = std::atan2(velocity.y, velocity.x);
+    double speed = std::clamp(static_cast<double>(velocity.Magnitude()) / Settings.maxSpeed, 0.0, 1.0);
+
+    PackedBoid<Coord> packed;
+    packed.x = static_cast<Coord>(std::llround(x * coordMax));
+    packed.y = static_cast<Coord>(std::llround(y * coordMax));
+    packed.heading = static_cast<uint16_t>(std::llround(angle / twoPi * headingSteps) & 0xFFFF);
+    packed.speed = static_cast<uint16_t>(std::llround(speed * speedSteps));
+    return packed;
+}
+
+template<typename Coord>
+Vec2 CompactFlock<Coord>::DecodePosition(const PackedBoid<Coord>& boid) const
+{
+    const double coordMax = static_cast<double>(std::numeric_limits<Coord>::max());
+    return Vec2(static_cast<float>(boid.x / coordMax * Settings.worldWidth),
+                static_cast<float>(boid.y / coordMax * Settings.worldHeight));
+}
+
+template<typename Coord>
+Vec2 CompactFlock<Coord>::DecodeVelocity(const PackedBoid<Coord>& boid) const
+{
+    float angle = static_cast<float>(boid.heading / headingSteps * twoPi);
+    float speed = static_cast<float>(boid.speed / speedSteps) * Settings.maxSpeed;
+    return Vec2(std::cos(angle) * speed, std::sin(angle) * speed);
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::Update()
+{
+    if (Analytics)
+        Analytics->BeginTick(Boids.size());
+
+    for (size_t i = 0; i < Boids.size(); i++)
+    {
+        UpdateBoid(i);
+    }
+
+    if (Analytics)
+        Analytics->EndTick();
+}
+
+template<typename Coord>
+void CompactFlock<Coord>::UpdateBoid(size_t index)
+{
+    const double coordMax = static_cast<double>(std::numeric_limits<Coord>::max());
+    const double cellX = Settings.worldWidth / coordMax;
+    const double cellY = Settings.worldHeight / coordMax;
+
+    // View range in fixed-point units, so far-away boids are rejected without being decoded.
+    const int64_t rangeX = static_cast<int64_t>(std::ceil(Settings.viewRange / cellX));
+    const int64_t rangeY = static_cast<int64_t>(std::ceil(Settings.viewRange / cellY));
+
+    const PackedBoid<Coord> self = Boids[index];
+    Vec2 position = DecodePosition(self);
+    Vec2 velocity = DecodeVelocity(self);
+
+    NeighborSums sums;
+    for (size_t j = 0; j < Boids.size(); j++)
+    {
+        if (j == index)
+            continue;
+
+        const PackedBoid<Coord> &other = Boids[j];
+        int64_t dx = static_cast<int64_t>(self.x) - static_cast<int64_t>(other.x);
+        int64_t dy = static_cast<int64_t>(self.y) - static_cast<int64_t>(other.y);
+        // One unsigned compare per axis, combined so the common far-away case costs a single branch.
+        bool outside = (static_cast<uint64_t>(dx + rangeX) > static_cast<uint64_t>(2 * rangeX)) |
+                       (static_cast<uint64_t>(dy + rangeY) > static_cast<uint64_t>(2 * rangeY));
+        if (outside)
+            continue;
+
+        Vec2 diff = Vec2(static_cast<float>(dx * cellX), static_cast<float>(dy * cellY));
+        float distance = diff.Magnitude();
+
+        if (Flock::CanSee(velocity, diff, distance, Settings))
+        {
+            sums.Add(diff, distance, position - diff, DecodeVelocity(other));
+            if (Analytics)
+                Analytics->AddNeighbor(static_cast<int>(index), static_cast<int>(j), distance);
+        }
+    }
+
+    Vec2 acceleration = Flock::FlockingForce(sums, position, Settings) + Flock::ObstacleForce(Colliders, position, velocity, Settings, rng);
+
+    Flock::Integrate(position, velocity, acceleration, Settings);
+
+    Boids[index] = Encode(position, velocity);
+
+    if (Analytics)
+        Analytics->AddBoid(velocity);
+}
+
+template<typename Coord>
+CompactReport CompactFlock<Coord>::Measure(const Flock& reference, int ticks, int freeRunTicks)
+{
+    CompactFlock<Coord> packed;
+    packed.Pack(reference);
+
+    // The float copy takes the packed settings, so both use metric neighbors even if reference is topological
+    // and any difference between them is quantization.
+    Flock floating;
+    floating.Settings = packed.Settings;
+    floating.Colliders = reference.Colliders;
+
+    CompactReport report = {};
+    report.bytesPerBoid = sizeof(PackedBoid<Coord>);
+    report.floatBytesPerBoid = sizeof(Boid);
+    report.ticks = ticks;
+
+    double positionSum = 0.0;
+    double headingSum = 0.0;
+    double speedSum = 0.0;
+    size_t samples = 0;
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        // Both start the tick from the same (quantized) state and the same random stream.
+        packed.Unpack(floating);
+        packed.Seed(tick);
+        floating.Seed(tick);
+
+        packed.Update();
+        floating.Update();
+
+        for (size_t i = 0; i < packed.Boids.size(); i++)
+        {
+            Vec2 p0 = packed.DecodePosition(packed.Boids[i]);
+            Vec2 p1 = floating.Boids[i].position;
+            Vec2 delta = Vec2(WrappedDelta(p0.x, p1.x, reference.Settings.worldWidth),
+                              WrappedDelta(p0.y, p1.y, reference.Settings.worldHeight));
+            float positionError = delta.Magnitude();
+
+            Vec2 v0 = packed.DecodeVelocity(packed.Boids[i]);
+            Vec2 v1 = floating.Boids[i].velocity;
+
+            positionSum += positionError;
+            headingSum += Vec2::AngleBetween(v0, v1) * (180.0 / M_PI);
+            speedSum += std::fabs(v0.Magnitude() - v1.Magnitude());
+            report.maxPositionError = std::max(report.maxPositionError, positionError);
+            samples++;
+        }
+    }
+
+    if (samples > 0)
+    {
+        report.meanPositionError = static_cast<float>(positionSum / samples);
+        report.meanHeadingError = static_cast<float>(headingSum / samples);
+        report.meanSpeedError = static_cast<float>(speedSum / samples);
+    }
+
+    // Free run: same quantized start and seed, then no re-synchronising.
+    FlockAnalytics packedAnalytics;
+    FlockAnalytics floatAnalytics;
+    packed.Pack(reference);
+    packed.Unpack(floating);
+    packed.Seed(1);
+    floating.Seed(1);
+    packed.Analytics = &packedAnalytics;
+    floating.Analytics = &floatAnalytics;
+
+    report.freeRunTicks = freeRunTicks;
+    for (int tick = 0; tick < freeRunTicks; tick++)
+    {
+        packed.Update();
+        floating.Update();
+        AddMetrics(report.packedRun, packedAnalytics.Latest());
+        AddMetrics(report.floatRun, floatAnalytics.Latest());
+    }
+    DivideMetrics(report.packedRun, freeRunTicks);
+    DivideMetrics(report.floatRun, freeRunTicks);
+
+    return report;
+}
+
+template class CompactFlock<uint16_t>;
+template class CompactFlock<uint32_t>;
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "Vec2.h"
+#include "Flock.h"
+
+// A boid in CompactFlock<Coord>. Its id is its index.
+// Position is fixed-point over the world extent (0..max of Coord).
+// Velocity is a heading (a full turn is 65536) and a speed (65535 is maxSpeed).
+template<typename Coord>
+struct PackedBoid
+{
+    Coord x;
+    Coord y;
+    uint16_t heading;
+    uint16_t speed;
+};
+
+// Flock-level metrics averaged over the ticks of a run.
+struct MetricMeans
+{
+    float flockCount;
+    float largestFlockFraction;
+    float polarization;
+    float nearestNeighborDistance;
+};
+
+struct CompactReport
+{
+    size_t bytesPerBoid;
+    size_t floatBytesPerBoid;
+    int ticks;
+
+    // Difference between one packed tick and one float tick from the same starting state, averaged over boids and ticks.
+    float meanPositionError;
+    float maxPositionError;
+    float meanHeadingError;
+    float meanSpeedError;
+
+    // Both flocks left to evolve on their own from the same start. Individual boids diverge,
+    // so only the flock-level statistics are comparable.
+    int freeRunTicks;
+    MetricMeans floatRun;
+    MetricMeans packedRun;
+};
+
+// Flock state stored as PackedBoid<uint16_t> (8 bytes) or PackedBoid<uint32_t> (12 bytes) instead of Boid.
+// Update() reads neighbors straight from the packed array, rejecting out-of-range ones in fixed-point
+// before anything is decoded, and shares its steering with Flock.
+template<typename Coord>
+class CompactFlock
+{
+    public:
+        FlockSettings Settings;
+        std::vector<PackedBoid<Coord>> Boids;
+        const ColliderWorld* Colliders = nullptr;
+        FlockAnalytics* Analytics = nullptr;
+
+        CompactFlock();
+
+        void Seed(unsigned int seed);
+
+        // Same random stream as Flock::CreateRandomBoids, so equal seeds give the same (quantized) start.
+        void CreateRandomBoids(size_t count);
+
+        // Copies settings, colliders and boids from a float flock; Analytics is left alone.
+        // neighborMode is reset to Metric, the only mode the packed kernel has.
+        void Pack(const Flock& flock);
+        void Unpack(Flock& flock) const;
+
+        PackedBoid<Coord> Encode(Vec2 position, Vec2 velocity) const;
+        Vec2 DecodePosition(const PackedBoid<Coord>& boid) const;
+        Vec2 DecodeVelocity(const PackedBoid<Coord>& boid) const;
+
+        void Update();
+        void UpdateBoid(size_t index);
+
+        // Steps a packed copy of reference and a float copy side by side for ticks ticks,
+        // re-synchronising every tick so the error reflects quantization rather than chaos.
+        // Then runs both freely for freeRunTicks and compares their flock metrics.
+        static CompactReport Measure(const Flock& reference, int ticks, int freeRunTicks);
+
+    private:
+        std::mt19937 rng;
+};
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include "Ensemble.h"
+
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "ColliderWorld.h"
+#include "FlockAnalytics.h"
+#include "TaskPool.h"
+
+namespace
+{
+    struct SettingField
+    {
+        const char* name;
+        float FlockSettings::* field;
+    };
+
+    const SettingField settingFields[] =
+    {
+        { "worldWidth", &FlockSettings::worldWidth },
+        { "worldHeight", &FlockSettings::worldHeight },
+        { "viewRange", &FlockSettings::viewRange },
+        { "viewFOV", &FlockSettings::viewFOV },
+        { "maxSpeed", &FlockSettings::maxSpeed },
+        { "acceleration", &FlockSettings::acceleration },
+        { "forwardAcceleration", &FlockSettings::forwardAcceleration },
+        { "separationStrength", &FlockSettings::separationStrength },
+        { "alignmentStrength", &FlockSettings::alignmentStrength },
+        { "cohesionStrength", &FlockSettings::cohesionStrength },
+        { "obstacleAvoidStrength", &FlockSettings::obstacleAvoidStrength },
+    };
+
+    const SettingField* FindSetting(const std::string& name)
+    {
+        for (const SettingField &setting : settingFields)
+        {
+            if (name == setting.name)
+                return &setting;
+        }
+        return nullptr;
+    }
+
+    // topologicalNeighbors also picks the neighbor mode: 0 is metric, k > 0 is the k nearest.
+    bool ApplySetting(FlockSettings& settings, const std::string& name, float value)
+    {
+        if (name == "topologicalNeighbors")
+        {
+            int k = static_cast<int>(value);
+            settings.neighborMode = k > 0 ? NeighborMode::Topological : NeighborMode::Metric;
+            if (k > 0)
+                settings.topologicalNeighbors = k;
+            return true;
+        }
+
+        const SettingField* setting = FindSetting(name);
+        if (!setting)
+            return false;
+        settings.*(setting->field) = value;
+        return true;
+    }
+
+    std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool ParseFloat(const std::string& text, float& value)
+    {
+        std::string trimmed = Trim(text);
+        if (trimmed.empty())
+            return false;
+
+        char* end = nullptr;
+        value = std::strtof(trimmed.c_str(), &end);
+        return *end == '\0';
+    }
+
+    // "a, b, c" or "start:end:step", end inclusive.
+    bool ParseValues(const std::string& text, std::vector<float>& values)
+    {
+        values.clear();
+
+        if (text.find(':') != std::string::npos)
+        {
+            std::stringstream stream(text);
+            std::string part;
+            std::vector<float> range;
+            while (std::getline(stream, part, ':'))
+            {
+                float value;
+                if (!ParseFloat(part, value))
+                    return false;
+                range.push_back(value);
+            }
+            if (range.size() != 3 || range[2] <= 0.0f || range[1] < range[0])
+                return false;
+
+            // Stepping by index avoids accumulating rounding error; the epsilon keeps the end value.
+            int steps = static_cast<int>(std::floor((range[1] - range[0]) / range[2] + 1e-4f));
+            for (int i = 0; i <= steps; i++)
+                values.push_back(range[0] + range[2] * i);
+            return true;
+        }
+
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, ','))
+        {
+            float value;
+            if (!ParseFloat(part, value))
+                return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+}
+
+Ensemble::Ensemble()
+{
+
+}
+
+bool Ensemble::Load(const std::string& path, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        error = "couldn't open " + path;
+        return false;
+    }
+
+    parameters.clear();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line = line.substr(0, comment);
+        line = Trim(line);
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+
+        std::string key = Trim(line.substr(0, equals));
+        std::vector<float> values;
+        if (!ParseValues(line.substr(equals + 1), values))
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": bad value list for " + key;
+            return false;
+        }
+
+        int* runSetting = key == "boids" ? &BoidCount
+                        : key == "ticks" ? &Ticks
+                        : key == "warmup" ? &WarmupTicks
+                        : key == "seeds" ? &Seeds
+                        : key == "threads" ? &Threads
+                        : nullptr;
+        if (runSetting)
+        {
+            if (values.size() != 1 || values[0] < 0)
+            {
+                error = path + ":" + std::to_string(lineNumber) + ": " + key + " takes one non-negative value";
+                return false;
+            }
+            *runSetting = static_cast<int>(values[0]);
+            continue;
+        }
+
+        // Applied to a scratch copy first, so an unknown key is caught whether or not it is swept.
+        FlockSettings check = BaseSettings;
+        if (!ApplySetting(check, key, values[0]))
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": unknown key " + key;
+            return false;
+        }
+
+        // A single value just changes the base settings; only real sweeps become summary columns.
+        if (values.size() == 1)
+            BaseSettings = check;
+        else
+            parameters.push_back({ key, values });
+    }
+
+    Seeds = std::max(1, Seeds);
+    return true;
+}
+
+int Ensemble::ParameterSetCount() const
+{
+    int count = 1;
+    for (const SweepParameter &parameter : parameters)
+        count *= static_cast<int>(parameter.values.size());
+    return count;
+}
+
+int Ensemble::WorldCount() const
+{
+    return ParameterSetCount() * Seeds;
+}
+
+void Ensemble::Run()
+{
+    results.assign(WorldCount(), EnsembleResult());
+    for (int set = 0; set < ParameterSetCount(); set++)
+    {
+        for (int seed = 0; seed < Seeds; seed++)
+        {
+            EnsembleResult &result = results[set * Seeds + seed];
+            result.parameterSet = set;
+            // The same seeds for every parameter set, so sets differ only by their parameters.
+            result.seed = static_cast<unsigned int>(seed + 1);
+        }
+    }
+
+    TaskPool pool(Threads);
+    for (EnsembleResult &result : results)
+        pool.Submit([this, &result] { RunWorld(result); });
+    pool.Wait();
+
+    steals = pool.StealCount();
+}
+
+bool Ensemble::WriteSummary(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    for (const SweepParameter &parameter : parameters)
+        file << parameter.name << ',';
+    file << "seeds,flocks,largest_flock_fraction,polarization,polarization_stddev,nearest_neighbor_distance,neighbors,ms_per_tick\n";
+
+    for (int set = 0; set < ParameterSetCount(); set++)
+    {
+        EnsembleResult mean;
+        double polarizationSqrSum = 0.0;
+        for (int seed = 0; seed < Seeds; seed++)
+        {
+            const EnsembleResult &result = results[set * Seeds + seed];
+            mean.flockCount += result.flockCount / Seeds;
+            mean.largestFlockFraction += result.largestFlockFraction / Seeds;
+            mean.polarization += result.polarization / Seeds;
+            mean.nearestNeighborDistance += result.nearestNeighborDistance / Seeds;
+            mean.neighborCount += result.neighborCount / Seeds;
+            mean.millisecondsPerTick += result.millisecondsPerTick / Seeds;
+            polarizationSqrSum += static_cast<double>(result.polarization) * result.polarization;
+        }
+        double variance = polarizationSqrSum / Seeds - static_cast<double>(mean.polarization) * mean.polarization;
+        double polarizationStddev = std::sqrt(std::max(0.0, variance));
+
+        for (size_t p = 0; p < parameters.size(); p++)
+            file << ParameterValue(set, p) << ',';
+        file << Seeds << ',' << mean.flockCount << ',' << mean.largestFlockFraction << ',' << mean.polarization << ','
+             << polarizationStddev << ',' << mean.nearestNeighborDistance << ',' << mean.neighborCount << ','
+             << mean.millisecondsPerTick << '\n';
+    }
+
+    return file.good();
+}
+
+const std::vector<EnsembleResult>& Ensemble::Results() const
+{
+    return results;
+}
+
+size_t Ensemble::StealCount() const
+{
+    return steals;
+}
+
+FlockSettings Ensemble::SettingsFor(int parameterSet) const
+{
+    FlockSettings settings = BaseSettings;
+    for (size_t p = 0; p < parameters.size(); p++)
+        ApplySetting(settings, parameters[p].name, ParameterValue(parameterSet, p));
+    return settings;
+}
+
+// Parameter sets enumerate the cartesian product with the first parameter varying fastest.
+float Ensemble::ParameterValue(int parameterSet, size_t parameter) const
+{
+    int index = parameterSet;
+    for (size_t p = 0; p < parameter; p++)
+        index /= static_cast<int>(parameters[p].values.size());
+    return parameters[parameter].values[index % parameters[parameter].values.size()];
+}
+
+void Ensemble::RunWorld(EnsembleResult& result) const
+{
+    FlockSettings settings = SettingsFor(result.parameterSet);
+    // Topological worlds build a k-d tree every tick; parallelism comes from running many worlds at once, not from inside one.
+    settings.treeBuildThreads = 1;
+
+    // The interactive app's invisible hollow border and centre box, scaled to the world. Unlike the app
+    // the box stays still, so a world's results depend only on its parameters and seed.
+    ColliderWorld colliders;
+    Collider worldBorder = Collider::Rectangle(0, 0, settings.worldWidth - 1, settings.worldHeight - 1);
+    worldBorder.IsHollow = true;
+    worldBorder.IsInvisible = true;
+    colliders.Add(worldBorder);
+    colliders.Add(Collider::Rectangle(settings.worldWidth * 0.375f, settings.worldHeight * 0.375f, settings.worldWidth / 16, settings.worldHeight / 16));
+
+    Flock flock;
+    flock.Settings = settings;
+    flock.Colliders = &colliders;
+    flock.Seed(result.seed);
+    flock.CreateRandomBoids(BoidCount);
+
+    for (int tick = 0; tick < WarmupTicks; tick++)
+        flock.Update();
+
+    FlockAnalytics analytics;
+    flock.Analytics = &analytics;
+
+    double flockSum = 0.0;
+    double largestSum = 0.0;
+    double polarizationSum = 0.0;
+    double nearestSum = 0.0;
+    double neighborSum = 0.0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < Ticks; tick++)
+    {
+        flock.Update();
+
+        const FlockMetrics &metrics = analytics.Latest();
+        flockSum += metrics.flockCount;
+        largestSum += metrics.boidCount > 0 ? static_cast<double>(metrics.largestFlock) / metrics.boidCount : 0.0;
+        polarizationSum += metrics.polarization;
+        nearestSum += metrics.meanNearestNeighborDistance;
+        neighborSum += metrics.meanNeighborCount;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (Ticks > 0)
+    {
+        result.flockCount = static_cast<float>(flockSum / Ticks);
+        result.largestFlockFraction = static_cast<float>(largestSum / Ticks);
+        result.polarization = static_cast<float>(polarizationSum / Ticks);
+        result.nearestNeighborDistance = static_cast<float>(nearestSum / Ticks);
+        result.neighborCount = static_cast<float>(neighborSum / Ticks);
+        result.millisecondsPerTick = std::chrono::duration<double, std::milli>(t1 - t0).count() / Ticks;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "Flock.h"
+
+struct SweepParameter
+{
+    std::string name;
+    std::vector<float> values;
+};
+
+// Metrics for one world, averaged over the ticks after warm-up.
+struct EnsembleResult
+{
+    int parameterSet = 0;
+    unsigned int seed = 0;
+
+    float flockCount = 0.0f;
+    float largestFlockFraction = 0.0f;
+    float polarization = 0.0f;
+    float nearestNeighborDistance = 0.0f;
+    float neighborCount = 0.0f;
+    double millisecondsPerTick = 0.0;
+};
+
+// Runs every combination of swept FlockSettings values, Seeds times each, as independent worlds in one process.
+// Each world is a single task on a work-stealing TaskPool, so many small worlds keep every core busy.
+//
+// Sweep files hold one "key = value" per line; '#' starts a comment. Values are a comma list
+// ("6, 12, 18") or a range ("0.1:0.5:0.1"). Keys are FlockSettings fields (separationStrength,
+// viewRange, ...) or the run settings boids, ticks, warmup, seeds and threads.
+// topologicalNeighbors selects the neighbor mode as well: 0 is metric, k > 0 uses the k nearest.
+class Ensemble
+{
+    public:
+        FlockSettings BaseSettings;
+        int BoidCount = 200;
+        int Ticks = 1000;
+        int WarmupTicks = 200;
+        int Seeds = 1;
+        // 0 uses every hardware thread.
+        int Threads = 0;
+
+        Ensemble();
+
+        bool Load(const std::string& path, std::string& error);
+
+        int ParameterSetCount() const;
+        int WorldCount() const;
+
+        void Run();
+        // One row per parameter set, metrics averaged over its seeds.
+        bool WriteSummary(const std::string& path) const;
+
+        const std::vector<EnsembleResult>& Results() const;
+        size_t StealCount() const;
+
+    private:
+        std::vector<SweepParameter> parameters;
+        std::vector<EnsembleResult> results;
+        size_t steals = 0;
+
+        FlockSettings SettingsFor(int parameterSet) const;
+        float ParameterValue(int parameterSet, size_t parameter) const;
+        void RunWorld(EnsembleResult& result) const;
+};
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "Flock.h"
+
+#include <cmath>
+#include <thread>
+
+void NeighborSums::Add(Vec2 diff, float distance, Vec2 otherPosition, Vec2 otherVelocity)
+{
+    separation = separation + (diff.Normalized() / distance);
+    alignment = alignment + otherVelocity;
+    cohesion = cohesion + otherPosition;
+    count++;
+}
+
+Flock::Flock() : rng(std::random_device{}())
+{
+
+}
+
+void Flock::Seed(unsigned int seed)
+{
+    rng.seed(seed);
+}
+
+void Flock::CreateRandomBoids(size_t count)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> x(0, Settings.worldWidth);
+    std::uniform_real_distribution<float> y(0, Settings.worldHeight);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Boid boid;
+        boid.id = static_cast<int>(Boids.size());
+        boid.position = Vec2(x(rng), y(rng));
+        // Start with an initial velocity (you can also use a random unit vector)
+        boid.velocity = Vec2(unit(rng), unit(rng));
+        boid.velocity.Normalize();
+        // Optionally initialize desiredDirection if still used elsewhere
+        boid.desiredDirection = boid.velocity;
+        Boids.push_back(boid);
+    }
+}
+
+void Flock::Update()
+{
+    if (Analytics)
+        Analytics->BeginTick(Boids.size());
+
+    if (Settings.neighborMode == NeighborMode::Topological)
+        BuildTree();
+
+    for (Boid &boid : Boids)
+    {
+        UpdateBoid(boid);
+    }
+
+    if (Analytics)
+        Analytics->EndTick();
+}
+
+void Flock::UpdateBoid(Boid &boid)
+{
+    NeighborSums sums;
+
+    // Process neighbors for separation, alignment, and cohesion forces
+    if (Settings.neighborMode == NeighborMode::Topological)
+        GatherTopologicalNeighbors(boid, sums);
+    else
+        GatherMetricNeighbors(boid, sums);
+
+    Vec2 acceleration = FlockingForce(sums, boid.position, Settings) + ObstacleForce(Colliders, boid.position, boid.velocity, Settings, rng);
+
+    Integrate(boid.position, boid.velocity, acceleration, Settings);
+
+    if (Analytics)
+        Analytics->AddBoid(boid.velocity);
+}
+
+void Flock::GatherMetricNeighbors(Boid &boid, NeighborSums &sums)
+{
+    for (Boid &other : Boids)
+    {
+        if (boid == other)
+            continue;
+
+        Vec2 diff = boid.position - other.position;
+        float distance = diff.Magnitude();
+
+        if (CanSee(boid.velocity, diff, distance, Settings))
+        {
+            sums.Add(diff, distance, other.position, other.velocity);
+            if (Analytics)
+                Analytics->AddNeighbor(boid.id, other.id, distance);
+        }
+    }
+}
+
+// Neighbors are chosen from the positions at the start of the tick, like the tree itself,
+// but forces use each neighbor's current state, as in the metric loop.
+void Flock::GatherTopologicalNeighbors(Boid &boid, NeighborSums &sums)
+{
+    const Vec2 origin = boid.position;
+    const Vec2 velocity = boid.velocity;
+    tree.Nearest(origin, Settings.topologicalNeighbors, Settings.viewRange, [&](int index)
+    {
+        Vec2 diff = origin - treePoints[index];
+        return CanSee(velocity, diff, diff.Magnitude(), Settings);
+    }, nearest);
+
+    for (const KdTree::Neighbor &neighbor : nearest)
+    {
+        Boid &other = Boids[neighbor.index];
+        Vec2 diff = boid.position - other.position;
+        float distance = diff.Magnitude();
+        if (distance <= 0)
+            continue;
+
+        sums.Add(diff, distance, other.position, other.velocity);
+        if (Analytics)
+            Analytics->AddNeighbor(boid.id, other.id, distance);
+    }
+}
+
+void Flock::BuildTree()
+{
+    treePoints.resize(Boids.size());
+    for (size_t i = 0; i < Boids.size(); i++)
+        treePoints[i] = Boids[i].position;
+
+    int threads = Settings.treeBuildThreads > 0 ? Settings.treeBuildThreads : static_cast<int>(std::thread::hardware_concurrency());
+    tree.Build(treePoints, threads);
+}
+
+bool Flock::CanSee(Vec2 velocity, Vec2 diff, float distance, const FlockSettings& settings)
+{
+    if (distance <= 0 || distance > settings.viewRange)
+        return false;
+
+    // diff points from the neighbor back to the boid, so the neighbor lies along -diff.
+    // AngleBetween is in radians and viewFOV in degrees.
+    float angle = Vec2::AngleBetween(velocity.Normalized(), (-diff).Normalized());
+    return angle <= settings.viewFOV * static_cast<float>(M_PI) / 360.0f;
+}
+
+Vec2 Flock::FlockingForce(const NeighborSums& sums, Vec2 position, const FlockSettings& settings)
+{
+    if (sums.count == 0)
+        return Vec2();
+
+    Vec2 separationForce = sums.separation / static_cast<float>(sums.count);
+    Vec2 alignmentForce = sums.alignment / static_cast<float>(sums.count);
+    Vec2 cohesionForce = (sums.cohesion / static_cast<float>(sums.count)) - position;
+
+    // For separation we keep the distance effect
+    separationForce = separationForce * settings.separationStrength;
+
+    if (alignmentForce.Magnitude() > 0)
+    {
+        alignmentForce.Normalize();
+        alignmentForce = alignmentForce * settings.alignmentStrength;
+    }
+    if (cohesionForce.Magnitude() > 0)
+    {
+        cohesionForce.Normalize();
+        cohesionForce = cohesionForce * settings.cohesionStrength;
+    }
+
+    return separationForce + alignmentForce + cohesionForce;
+}
+
+Vec2 Flock::ObstacleForce(const ColliderWorld* colliders, Vec2 position, Vec2 velocity, const FlockSettings& settings, std::mt19937& rng)
+{
+    Vec2 obstacleForce;
+
+    // Process obstacle avoidance via raycasting
+    std::vector<RayHit> hits;
+    // Using a maxDistance (e.g., 200) and a ray count (e.g., 8) for your FOV rays
+    if (colliders)
+        Physics2D::RaycastMulti(*colliders, Physics2D::CreateFOVRays(position, velocity, 180, 200, 8), hits);
+
+    int hitCount = 0;
+    for (RayHit &hit : hits)
+    {
+        if (!hit.hit)
+            continue;
+
+        // Determine how close the obstacle is relative to the ray's max distance.
+        float t = hit.distance / hit.ray.maxDistance;  // 0 when very close, 1 when at max distance
+        // Use a quadratic falloff so that the avoidance force increases more sharply as you get closer.
+        float falloff = (1.0f - t) * (1.0f - t);
+
+        // Calculate an avoidance direction that steers away from the obstacle.
+        Vec2 avoidanceDir = position - hit.point;
+        if (avoidanceDir.Magnitude() > 1e-6f)
+            avoidanceDir.Normalize();
+
+        // Add the weighted avoidance direction.
+        obstacleForce = obstacleForce + (avoidanceDir * falloff);
+        hitCount++;
+    }
+
+    if (hitCount > 0)
+    {
+        obstacleForce = obstacleForce / static_cast<float>(hitCount);
+        obstacleForce = obstacleForce * settings.obstacleAvoidStrength;
+    }
+
+    // The angle is drawn for every boid, used or not, so two flocks seeded alike stay in step
+    // even when a boid near a wall takes a different branch in each.
+    std::uniform_real_distribution<float> turn(0.0f, 2.0f * static_cast<float>(M_PI));
+    float randomAngle = turn(rng);
+
+    // If the computed obstacle force is nearly zero, pick a random avoidance direction.
+    // This helps when all rays return too-similar (or weak) data, so the boid can choose a direction.
+    if (obstacleForce.Magnitude() < 1e-3f)
+    {
+        obstacleForce = Vec2(std::cos(randomAngle), std::sin(randomAngle)) * settings.obstacleAvoidStrength;
+    }
+
+    return obstacleForce;
+}
+
+void Flock::Integrate(Vec2& position, Vec2& velocity, Vec2 acceleration, const FlockSettings& settings)
+{
+    // Add constant forward acceleration if below max speed.
+    float currentSpeed = velocity.Magnitude();
+    if (currentSpeed > 1e-6f && currentSpeed < settings.maxSpeed)
+    {
+        acceleration = acceleration + velocity.Normalized() * settings.forwardAcceleration;
+    }
+
+    // Update velocity and clamp to maxSpeed.
+    velocity = velocity + acceleration * settings.acceleration;
+    if (velocity.Magnitude() > settings.maxSpeed)
+        velocity.SetLength(settings.maxSpeed);
+
+    position = position + velocity;
+
+    // Wrap around screen boundaries.
+    if (position.x < 0) position.x = settings.worldWidth;
+    else if (position.x > settings.worldWidth) position.x = 0;
+
+    if (position.y < 0) position.y = settings.worldHeight;
+    else if (position.y > settings.worldHeight) position.y = 0;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include "Vec2.h"
+#include "Boid.h"
+#include "ColliderWorld.h"
+#include "FlockAnalytics.h"
+#include "KdTree.h"
+
+enum class NeighborMode
+{
+    // Every visible boid within viewRange.
+    Metric,
+    // The topologicalNeighbors nearest visible boids within viewRange, found through a k-d tree.
+    Topological
+};
+
+struct FlockSettings
+{
+    float worldWidth = 800.0f;
+    float worldHeight = 800.0f;
+
+    float viewRange = 60.0f;
+    // Degrees, centred on the heading.
+    float viewFOV = 270.0f;
+
+    NeighborMode neighborMode = NeighborMode::Metric;
+    int topologicalNeighbors = 7;
+    // Threads used to rebuild the k-d tree each tick; 0 uses every hardware thread.
+    int treeBuildThreads = 0;
+
+    float maxSpeed = 4.0f;
+    float acceleration = 0.2f;
+    float forwardAcceleration = 0.5f;
+
+    float separationStrength = 12.0f;
+    float alignmentStrength = 0.2f;
+    float cohesionStrength = 0.4f;
+    float obstacleAvoidStrength = 5.0f;
+};
+
+// Running sums over the neighbors a boid can see.
+struct NeighborSums
+{
+    Vec2 separation;
+    Vec2 alignment;
+    Vec2 cohesion;
+    int count = 0;
+
+    void Add(Vec2 diff, float distance, Vec2 otherPosition, Vec2 otherVelocity);
+};
+
+class Flock
+{
+    public:
+        FlockSettings Settings;
+        std::vector<Boid> Boids;
+        const ColliderWorld* Colliders = nullptr;
+        // When set, receives every visible neighbor pair and final velocity during Update().
+        FlockAnalytics* Analytics = nullptr;
+
+        Flock();
+
+        void Seed(unsigned int seed);
+        void CreateRandomBoids(size_t count);
+
+        void Update();
+        void UpdateBoid(Boid& boid);
+
+        // Steering pieces shared by every state representation, so they all move boids the same way.
+        static bool CanSee(Vec2 velocity, Vec2 diff, float distance, const FlockSettings& settings);
+        static Vec2 FlockingForce(const NeighborSums& sums, Vec2 position, const FlockSettings& settings);
+        static Vec2 ObstacleForce(const ColliderWorld* colliders, Vec2 position, Vec2 velocity, const FlockSettings& settings, std::mt19937& rng);
+        static void Integrate(Vec2& position, Vec2& velocity, Vec2 acceleration, const FlockSettings& settings);
+
+    private:
+        std::mt19937 rng;
+
+        KdTree tree;
+        std::vector<Vec2> treePoints;
+        std::vector<KdTree::Neighbor> nearest;
+
+        void BuildTree();
+        void GatherMetricNeighbors(Boid& boid, NeighborSums& sums);
+        void GatherTopologicalNeighbors(Boid& boid, NeighborSums& sums);
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "FlockAnalytics.h"
+
+#include <algorithm>
+#include <limits>
+
+FlockAnalytics::FlockAnalytics()
+{
+
+}
+
+void FlockAnalytics::BeginTick(size_t boidCount)
+{
+    parent.resize(boidCount);
+    for (size_t i = 0; i < boidCount; i++)
+        parent[i] = static_cast<int>(i);
+
+    groupSize.assign(boidCount, 1);
+    nearest.assign(boidCount, std::numeric_limits<float>::max());
+    neighborCount.assign(boidCount, 0);
+    headingSum = Vec2();
+}
+
+void FlockAnalytics::AddNeighbor(int boid, int neighbor, float distance)
+{
+    Union(boid, neighbor);
+    nearest[boid] = std::min(nearest[boid], distance);
+    neighborCount[boid]++;
+}
+
+void FlockAnalytics::AddBoid(Vec2 velocity)
+{
+    headingSum = headingSum + velocity.Normalized();
+}
+
+void FlockAnalytics::EndTick()
+{
+    FlockMetrics metrics;
+    metrics.tick = tick++;
+    metrics.boidCount = static_cast<int>(parent.size());
+
+    double nearestSum = 0.0;
+    int nearestCount = 0;
+    long long neighborSum = 0;
+
+    for (size_t i = 0; i < parent.size(); i++)
+    {
+        if (parent[i] == static_cast<int>(i))
+        {
+            metrics.flockCount++;
+            metrics.largestFlock = std::max(metrics.largestFlock, groupSize[i]);
+        }
+
+        if (neighborCount[i] > 0)
+        {
+            nearestSum += nearest[i];
+            nearestCount++;
+        }
+        neighborSum += neighborCount[i];
+    }
+
+    if (metrics.boidCount > 0)
+    {
+        metrics.polarization = headingSum.Magnitude() / metrics.boidCount;
+        metrics.meanNeighborCount = static_cast<float>(static_cast<double>(neighborSum) / metrics.boidCount);
+    }
+    if (nearestCount > 0)
+        metrics.meanNearestNeighborDistance = static_cast<float>(nearestSum / nearestCount);
+
+    latest = metrics;
+
+    if (csv.is_open())
+    {
+        csv << metrics.tick << ',' << metrics.boidCount << ',' << metrics.flockCount << ',' << metrics.largestFlock << ','
+            << metrics.polarization << ',' << metrics.meanNearestNeighborDistance << ',' << metrics.meanNeighborCount << '\n';
+    }
+}
+
+const FlockMetrics& FlockAnalytics::Latest() const
+{
+    return latest;
+}
+
+size_t FlockAnalytics::BytesPerBoid()
+{
+    return 2 * sizeof(int) + sizeof(float) + sizeof(int);
+}
+
+bool FlockAnalytics::OpenCsv(const std::string& path)
+{
+    csv.open(path, std::ios::out | std::ios::trunc);
+    if (!csv.is_open())
+        return false;
+
+    csv << "tick,boids,flocks,largest_flock,polarization,mean_nearest_neighbor_distance,mean_neighbor_count\n";
+    return true;
+}
+
+void FlockAnalytics::CloseCsv()
+{
+    if (csv.is_open())
+        csv.close();
+}
+
+// Path halving keeps the trees shallow without a second pass.
+int FlockAnalytics::Find(int boid)
+{
+    while (parent[boid] != boid)
+    {
+        parent[boid] = parent[parent[boid]];
+        boid = parent[boid];
+    }
+    return boid;
+}
+
+void FlockAnalytics::Union(int a, int b)
+{
+    a = Find(a);
+    b = Find(b);
+    if (a == b)
+        return;
+
+    if (groupSize[a] < groupSize[b])
+        std::swap(a, b);
+
+    parent[b] = a;
+    groupSize[a] += groupSize[b];
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+
+#include "Vec2.h"
+
+struct FlockMetrics
+{
+    long tick = 0;
+    int boidCount = 0;
+
+    // Connected groups of boids linked by "can see" pairs, treated as undirected.
+    int flockCount = 0;
+    int largestFlock = 0;
+
+    // Length of the mean unit heading: 1 when every boid flies the same way, near 0 when disordered.
+    float polarization = 0.0f;
+    // Over boids that see at least one neighbor.
+    float meanNearestNeighborDistance = 0.0f;
+    float meanNeighborCount = 0.0f;
+};
+
+// Flock health metrics computed from the neighbor pairs the update kernel already visits.
+// The kernel reports pairs and final velocities during the tick; EndTick() folds them into metrics.
+class FlockAnalytics
+{
+    public:
+        FlockAnalytics();
+
+        void BeginTick(size_t boidCount);
+        void AddNeighbor(int boid, int neighbor, float distance);
+        void AddBoid(Vec2 velocity);
+        void EndTick();
+
+        const FlockMetrics& Latest() const;
+
+        // Per-boid working memory held while attached to a flock.
+        static size_t BytesPerBoid();
+
+        // Appends one line per tick to path until CloseCsv().
+        bool OpenCsv(const std::string& path);
+        void CloseCsv();
+
+    private:
+        std::vector<int> parent;
+        std::vector<int> groupSize;
+        std::vector<float> nearest;
+        std::vector<int> neighborCount;
+
+        Vec2 headingSum;
+        FlockMetrics latest;
+        long tick = 0;
+
+        std::ofstream csv;
+
+        int Find(int boid);
+        void Union(int a, int b);
+};
\ No newline at end of file
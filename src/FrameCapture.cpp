@@ -0,0 +1,213 @@
+#include "FrameCapture.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <cstdio>
+#include <cstring>
+
+FrameCapture::FrameCapture()
+{
+
+}
+
+FrameCapture::~FrameCapture()
+{
+    Stop();
+}
+
+bool FrameCapture::Start(const std::string& directory, CaptureFormat format, int width, int height, int bufferCount, int workerCount)
+{
+    if (running || width <= 0 || height <= 0 || bufferCount < 1 || workerCount < 1)
+        return false;
+
+    if (!SDL_CreateDirectory(directory.c_str()))
+    {
+        SDL_Log("Couldn't create capture directory %s: %s", directory.c_str(), SDL_GetError());
+        return false;
+    }
+
+    this->directory = directory;
+    this->format = format;
+    this->width = width;
+    this->height = height;
+
+    // Every buffer is allocated up front; after this point frames only move between the free list and the queue.
+    buffers.assign(bufferCount, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4));
+    freeBuffers.clear();
+    for (std::vector<uint8_t> &buffer : buffers)
+        freeBuffers.push_back(&buffer);
+
+    submitted = 0;
+    nextFrame = 0;
+    droppedTicks.clear();
+    dropped = 0;
+    written = 0;
+    running = true;
+
+    for (int i = 0; i < workerCount; i++)
+        workers.emplace_back(&FrameCapture::WorkerLoop, this);
+
+    return true;
+}
+
+void FrameCapture::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+            return;
+        running = false;
+    }
+    frameReady.notify_all();
+    bufferFree.notify_all();
+
+    // Workers drain whatever is still queued before they exit.
+    for (std::thread &worker : workers)
+        worker.join();
+    workers.clear();
+
+    if (droppedTicks.empty())
+        return;
+
+    std::string path = directory + "/dropped_ticks.txt";
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+    {
+        SDL_Log("Couldn't open %s for writing", path.c_str());
+        return;
+    }
+    for (size_t tick : droppedTicks)
+        std::fprintf(file, "%zu\n", tick);
+    std::fclose(file);
+}
+
+bool FrameCapture::Submit(const void* pixels, int pitch)
+{
+    std::vector<uint8_t>* buffer = nullptr;
+    size_t index;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!running)
+            return false;
+
+        size_t tick = submitted++;
+        if (BlockWhenFull)
+            bufferFree.wait(lock, [this] { return !running || !freeBuffers.empty(); });
+
+        if (freeBuffers.empty())
+        {
+            droppedTicks.push_back(tick);
+            dropped++;
+            return false;
+        }
+
+        // Only frames that will be written take a number, so the sequence has no gaps.
+        index = nextFrame++;
+        buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+    }
+
+    // The buffer is owned by this thread until it is queued, so the copy happens outside the lock.
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    const uint8_t* src = static_cast<const uint8_t*>(pixels);
+    for (int y = 0; y < height; y++)
+        std::memcpy(buffer->data() + y * rowBytes, src + static_cast<size_t>(y) * pitch, rowBytes);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back({ index, buffer });
+    }
+    frameReady.notify_one();
+
+    return true;
+}
+
+size_t FrameCapture::FramesSubmitted() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return submitted;
+}
+
+size_t FrameCapture::FramesQueued() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+size_t FrameCapture::FramesDropped() const
+{
+    return dropped;
+}
+
+size_t FrameCapture::FramesWritten() const
+{
+    return written;
+}
+
+std::vector<size_t> FrameCapture::DroppedTicks() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedTicks;
+}
+
+void FrameCapture::WorkerLoop()
+{
+    while (true)
+    {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait(lock, [this] { return !running || !pending.empty(); });
+
+            if (pending.empty())
+                return;
+
+            frame = pending.front();
+            pending.pop_front();
+        }
+
+        if (WriteFrame(frame))
+            written++;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(frame.buffer);
+        }
+        bufferFree.notify_one();
+    }
+}
+
+bool FrameCapture::WriteFrame(const Frame& frame)
+{
+    char name[64];
+    SDL_snprintf(name, sizeof(name), "/frame_%06zu.%s", frame.index, format == CaptureFormat::PNG ? "png" : "rgba");
+    std::string path = directory + name;
+
+    if (format == CaptureFormat::Raw)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            SDL_Log("Couldn't open %s for writing", path.c_str());
+            return false;
+        }
+        size_t count = std::fwrite(frame.buffer->data(), 1, frame.buffer->size(), file);
+        std::fclose(file);
+        return count == frame.buffer->size();
+    }
+
+    // Wrap the pooled buffer without copying it; the surface only borrows the pixels.
+    SDL_Surface* surface = SDL_CreateSurfaceFrom(width, height, SDL_PIXELFORMAT_RGBA32, frame.buffer->data(), width * 4);
+    if (!surface)
+    {
+        SDL_Log("Couldn't wrap capture buffer: %s", SDL_GetError());
+        return false;
+    }
+
+    bool ok = IMG_SavePNG(surface, path.c_str());
+    if (!ok)
+        SDL_Log("Couldn't write %s: %s", path.c_str(), SDL_GetError());
+
+    SDL_DestroySurface(surface);
+    return ok;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+enum class CaptureFormat
+{
+    PNG,
+    Raw
+};
+
+// Hands rendered frames to a pool of encoder threads that write them out as an image sequence.
+// Pixel buffers are allocated once and recycled, so submitting a frame never allocates or touches the disk.
+class FrameCapture
+{
+    public:
+        // Wait for a free buffer instead of dropping the frame. For offline renders where every tick must be kept.
+        bool BlockWhenFull = false;
+
+        FrameCapture();
+        ~FrameCapture();
+
+        bool Start(const std::string& directory, CaptureFormat format, int width, int height, int bufferCount, int workerCount);
+        void Stop();
+
+        // Copies an RGBA32 frame into a free buffer and queues it for encoding.
+        // If every buffer is still in flight the frame is dropped (or, with BlockWhenFull, waits for one).
+        // Written frames are numbered contiguously; the ticks that were dropped are listed by DroppedTicks()
+        // and written to dropped_ticks.txt by Stop().
+        bool Submit(const void* pixels, int pitch);
+
+        size_t FramesSubmitted() const;
+        size_t FramesQueued() const;
+        size_t FramesDropped() const;
+        size_t FramesWritten() const;
+        std::vector<size_t> DroppedTicks() const;
+
+    private:
+        struct Frame
+        {
+            size_t index;
+            std::vector<uint8_t>* buffer;
+        };
+
+        std::string directory;
+        CaptureFormat format = CaptureFormat::PNG;
+        int width = 0;
+        int height = 0;
+
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<std::vector<uint8_t>*> freeBuffers;
+        std::deque<Frame> pending;
+        std::vector<std::thread> workers;
+
+        mutable std::mutex mutex;
+        std::condition_variable frameReady;
+        std::condition_variable bufferFree;
+        bool running = false;
+
+        size_t submitted = 0;
+        size_t nextFrame = 0;
+        std::vector<size_t> droppedTicks;
+        std::atomic<size_t> dropped{0};
+        std::atomic<size_t> written{0};
+
+        void WorkerLoop();
+        bool WriteFrame(const Frame& frame);
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "KdTree.h"
+
+#include <thread>
+
+namespace
+{
+    // Below this many points a split isn't worth starting a thread for.
+    const int parallelBuildThreshold = 4096;
+}
+
+KdTree::KdTree()
+{
+
+}
+
+void KdTree::Build(const std::vector<Vec2>& points, int threadCount)
+{
+    entries.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++)
+        entries[i] = { points[i], static_cast<int>(i) };
+
+    BuildRange(0, static_cast<int>(entries.size()), 0, std::max(1, threadCount));
+}
+
+void KdTree::BuildRange(int begin, int end, int depth, int threadCount)
+{
+    if (end - begin <= 1)
+        return;
+
+    int mid = begin + (end - begin) / 2;
+    bool splitX = depth % 2 == 0;
+
+    std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end, [splitX](const Entry& a, const Entry& b)
+    {
+        return splitX ? a.point.x < b.point.x : a.point.y < b.point.y;
+    });
+
+    // The two halves don't overlap, so they can be built at the same time.
+    if (threadCount > 1 && end - begin >= parallelBuildThreshold)
+    {
+        int leftThreads = threadCount / 2;
+        std::thread left(&KdTree::BuildRange, this, begin, mid, depth + 1, leftThreads);
+        BuildRange(mid + 1, end, depth + 1, threadCount - leftThreads);
+        left.join();
+        return;
+    }
+
+    BuildRange(begin, mid, depth + 1, 1);
+    BuildRange(mid + 1, end, depth + 1, 1);
+}
\ No newline at end of file
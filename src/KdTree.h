@@ -0,0 +1,102 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "Vec2.h"
+
+// Implicit 2D k-d tree: points are reordered so every range's median splits it, alternating x and y by depth.
+// No nodes are allocated, so rebuilding every tick is a copy plus nth_element passes.
+class KdTree
+{
+    public:
+        struct Neighbor
+        {
+            int index;
+            float sqrDistance;
+        };
+
+        KdTree();
+
+        // Subtrees are handed to other threads near the top, up to threadCount threads in total.
+        void Build(const std::vector<Vec2>& points, int threadCount);
+
+        // Collects up to k points within maxDistance for which accept(index) is true, nearest first.
+        // Indices refer to the points passed to Build().
+        template<typename Filter>
+        int Nearest(Vec2 point, int k, float maxDistance, Filter accept, std::vector<Neighbor>& result) const;
+
+    private:
+        struct Entry
+        {
+            Vec2 point;
+            int index;
+        };
+
+        std::vector<Entry> entries;
+
+        void BuildRange(int begin, int end, int depth, int threadCount);
+
+        template<typename Filter>
+        void Search(int begin, int end, int depth, Vec2 point, int k, float maxSqrDistance, Filter& accept, std::vector<Neighbor>& heap) const;
+
+        static bool Closer(const Neighbor& a, const Neighbor& b) { return a.sqrDistance < b.sqrDistance; }
+};
+
+template<typename Filter>
+int KdTree::Nearest(Vec2 point, int k, float maxDistance, Filter accept, std::vector<Neighbor>& result) const
+{
+    result.clear();
+    if (k <= 0)
+        return 0;
+
+    Search(0, static_cast<int>(entries.size()), 0, point, k, maxDistance * maxDistance, accept, result);
+
+    // result is a max-heap on distance while searching.
+    std::sort_heap(result.begin(), result.end(), Closer);
+    return static_cast<int>(result.size());
+}
+
+template<typename Filter>
+void KdTree::Search(int begin, int end, int depth, Vec2 point, int k, float maxSqrDistance, Filter& accept, std::vector<Neighbor>& heap) const
+{
+    if (begin >= end)
+        return;
+
+    int mid = begin + (end - begin) / 2;
+    const Entry &candidate = entries[mid];
+    float dx = point.x - candidate.point.x;
+    float dy = point.y - candidate.point.y;
+    float sqrDistance = dx * dx + dy * dy;
+
+    // Until k are found anything inside maxDistance qualifies; after that only beating the current worst does.
+    float worst = static_cast<int>(heap.size()) < k ? maxSqrDistance : heap.front().sqrDistance;
+    if (sqrDistance <= worst && accept(candidate.index))
+    {
+        heap.push_back({ candidate.index, sqrDistance });
+        std::push_heap(heap.begin(), heap.end(), Closer);
+        if (static_cast<int>(heap.size()) > k)
+        {
+            std::pop_heap(heap.begin(), heap.end(), Closer);
+            heap.pop_back();
+        }
+    }
+
+    float delta = (depth % 2 == 0) ? dx : dy;
+    bool nearLeft = delta < 0;
+
+    if (nearLeft)
+        Search(begin, mid, depth + 1, point, k, maxSqrDistance, accept, heap);
+    else
+        Search(mid + 1, end, depth + 1, point, k, maxSqrDistance, accept, heap);
+
+    worst = static_cast<int>(heap.size()) < k ? maxSqrDistance : heap.front().sqrDistance;
+    if (delta * delta > worst)
+        return;
+
+    if (nearLeft)
+        Search(mid + 1, end, depth + 1, point, k, maxSqrDistance, accept, heap);
+    else
+        Search(begin, mid, depth + 1, point, k, maxSqrDistance, accept, heap);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Physics2D.h"
+#include "ColliderWorld.h"
 
 #include <vector>
 #include <cmath>
@@ -160,3 +161,21 @@ bool Physics2D::RaycastMulti(const std::vector<Collider> &colliders, const std::
     }
     return anyHit;
 }
+
+bool Physics2D::Raycast(const ColliderWorld &colliders, Ray ray, RayHit &hitInfo)
+{
+    return colliders.Raycast(ray, hitInfo);
+}
+
+bool Physics2D::RaycastMulti(const ColliderWorld &colliders, const std::vector<Ray> &rays, std::vector<RayHit> &hitInfos)
+{
+    bool anyHit = false;
+    hitInfos.resize(rays.size());
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        if (colliders.Raycast(rays[i], hitInfos[i]))
+            anyHit = true;
+    }
+    return anyHit;
+}
\ No newline at end of file
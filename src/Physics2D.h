@@ -5,6 +5,8 @@
 #include "Vec2.h"
 #include "Collider.h"
 
+class ColliderWorld;
+
 struct Ray
 {
     Vec2 origin;
@@ -29,4 +31,6 @@ class Physics2D
         static bool GetColliderIntersection(const Collider& collider, const Ray& ray, RayHit& hitInfo);
         static bool Raycast(const std::vector<Collider>& colliders, Ray ray, RayHit& hitInfo);
         static bool RaycastMulti(const std::vector<Collider>& colliders, const std::vector<Ray>& rays, std::vector<RayHit>& hitInfos);
+        static bool Raycast(const ColliderWorld& colliders, Ray ray, RayHit& hitInfo);
+        static bool RaycastMulti(const ColliderWorld& colliders, const std::vector<Ray>& rays, std::vector<RayHit>& hitInfos);
 };
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+
+TaskPool::TaskPool(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < threadCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (int i = 0; i < threadCount; i++)
+        threads.emplace_back(&TaskPool::WorkerLoop, this, i);
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+void TaskPool::Submit(std::function<void()> task)
+{
+    unfinished++;
+
+    // Counted before it is pushed, so a worker can never take it while queued still reads zero.
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued++;
+    }
+
+    Queue &queue = *queues[nextQueue];
+    nextQueue = (nextQueue + 1) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void TaskPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return unfinished == 0; });
+}
+
+int TaskPool::ThreadCount() const
+{
+    return static_cast<int>(threads.size());
+}
+
+size_t TaskPool::StealCount() const
+{
+    return steals;
+}
+
+void TaskPool::WorkerLoop(int index)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0)
+                return;
+        }
+
+        std::function<void()> task;
+        if (!TakeTask(index, task))
+            continue;
+
+        task();
+
+        if (--unfinished == 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            allDone.notify_all();
+        }
+    }
+}
+
+bool TaskPool::TakeTask(int index, std::function<void()>& task)
+{
+    // Own work first, newest first: it is the most likely to still be warm in cache.
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    // Then steal the oldest task from the next busy worker along.
+    for (size_t offset = 1; offset < queues.size(); offset++)
+    {
+        Queue &victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
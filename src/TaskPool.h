@@ -0,0 +1,51 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Fixed set of worker threads, each with its own task deque.
+// A worker takes from the back of its own deque and, when that is empty, steals from the front of the others'.
+class TaskPool
+{
+    public:
+        // 0 uses every hardware thread.
+        explicit TaskPool(int threadCount = 0);
+        ~TaskPool();
+
+        // Tasks are dealt round-robin onto the workers' deques. Call from one thread only.
+        void Submit(std::function<void()> task);
+        // Blocks until every submitted task has finished.
+        void Wait();
+
+        int ThreadCount() const;
+        size_t StealCount() const;
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        size_t nextQueue = 0;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable allDone;
+        std::atomic<size_t> queued{0};
+        std::atomic<size_t> unfinished{0};
+        std::atomic<size_t> steals{0};
+        bool stopping = false;
+
+        void WorkerLoop(int index);
+        bool TakeTask(int index, std::function<void()>& task);
+};
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <cmath>
 #include <random>
 #include <chrono>
+#include <string>
+#include <thread>
 
 #include "imgui.h"
 #include "imgui_impl_sdl3.h"
@@ -15,6 +17,12 @@
 #include "Boid.h"
 #include "Collider.h"
 #include "Physics2D.h"
+#include "ColliderWorld.h"
+#include "FrameCapture.h"
+#include "Flock.h"
+#include "CompactFlock.h"
+#include "FlockAnalytics.h"
+#include "Ensemble.h"
 
 const int windowWidth = 800;
 const int windowHeight = 800;
@@ -23,42 +31,103 @@ const int tickRate = 60;
 const int initialBoidCount = 200;
 
 const float boidSize = 15;
-const float boidViewRange = 60.0f;
-const float boidViewFOV = 270.0f;
 
-const float boidMaxSpeed = 4.0f;
-const float boidAcceleration = 0.2f;
+const float obstacleSpinSpeed = 0.5f;
+const float editorBoxSize = 50.0f;
 
-const float boidSeparationStrength = 12.0f;
-const float boidAlignmentStrength = 0.2f;
-const float boidCohesionStrength = 0.4f;
-const float boidObstacleAvoidStrength = 5.0f;
+const int captureBuffersPerWorker = 4;
+// Above this share of dropped ticks the sequence no longer resembles real-time playback.
+const double captureDropWarningRatio = 0.05;
+const int compactReportWarmupTicks = 600;
+const int compactFreeRunTicks = 600;
+
+enum class RunMode
+{
+    Window,
+    Capture,
+    CompactReport,
+    Ensemble
+};
 
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
 static SDL_Texture *boidTexture = NULL;
 static SDL_GLContext gl_context = NULL;
 
+static RunMode runMode = RunMode::Window;
+static int boidCount = initialBoidCount;
+
+// Headless capture renders into this surface through the software renderer; no window is created.
+static SDL_Surface *captureSurface = NULL;
+static std::string captureDirectory;
+static CaptureFormat captureFormat = CaptureFormat::PNG;
+static int captureFrameLimit = 600;
+static int captureFrameCount = 0;
+static bool captureBlockWhenFull = false;
+
+static int spinningObstacle = -1;
+static int draggedCollider = -1;
+static Vec2 dragOffset;
+
+// 0 runs the float state; 16 or 32 runs the matching packed state instead.
+static int compactBits = 0;
+static int compactReportTicks = 120;
+
+static std::string metricsPath;
+
+static NeighborMode neighborMode = NeighborMode::Metric;
+static int topologicalNeighbors = 7;
+
+static std::string ensembleSpecPath;
+static std::string ensembleSummaryPath = "ensemble_summary.csv";
+
 using namespace std;
 
-vector<Boid> Boids;
-vector<Collider> Colliders;
+Flock Simulation;
+CompactFlock<uint16_t> Compact16;
+CompactFlock<uint32_t> Compact32;
+ColliderWorld Colliders;
+FrameCapture Capture;
+FlockAnalytics Analytics;
+
+void DrawBoid(Vec2 position, Vec2 velocity)
+{
+    SDL_FRect rect = { position.x - boidSize / 2, position.y - boidSize / 2, boidSize, boidSize };
+    float angle = SDL_atan2f(velocity.x, -velocity.y) * (180.0f / M_PI);
+    SDL_RenderTextureRotated(renderer, boidTexture, nullptr, &rect, angle, nullptr, SDL_FLIP_NONE);
+}
+
+template<typename Coord>
+void DrawCompactBoids(const CompactFlock<Coord> &flock)
+{
+    for (const PackedBoid<Coord> &boid : flock.Boids)
+    {
+        DrawBoid(flock.DecodePosition(boid), flock.DecodeVelocity(boid));
+    }
+}
 
 void DrawBoids()
 {
-    for (Boid &boid : Boids)
+    if (compactBits == 16)
+        return DrawCompactBoids(Compact16);
+    if (compactBits == 32)
+        return DrawCompactBoids(Compact32);
+
+    for (Boid &boid : Simulation.Boids)
     {
-        SDL_FRect rect = { boid.position.x - boidSize / 2, boid.position.y - boidSize / 2, boidSize, boidSize };
-        float angle = SDL_atan2f(boid.velocity.x, -boid.velocity.y) * (180.0f / M_PI);
-        SDL_RenderTextureRotated(renderer, boidTexture, nullptr, &rect, angle, nullptr, SDL_FLIP_NONE);
+        DrawBoid(boid.position, boid.velocity);
     }
 }
 
 void DrawColliders()
 {
     SDL_SetRenderDrawColorFloat(renderer, 1, 0.3, 0, SDL_ALPHA_OPAQUE_FLOAT);
-    for (Collider &collider : Colliders)
+    for (int slot = 0; slot < Colliders.SlotCount(); slot++)
     {
+        const Collider *found = Colliders.Get(Colliders.HandleAt(slot));
+        if (!found) continue;
+
+        const Collider &collider = *found;
         if (collider.IsInvisible) continue;
 
         for (size_t i = 0; i < collider.Points.size()-1; i++)
@@ -95,160 +164,286 @@ void DrawRays(vector<RayHit>& hitInfos)
     }
 }
 
-float randomFloat(float min, float max)
+void MoveColliders()
+{
+    if (Collider *obstacle = Colliders.Get(spinningObstacle))
+        Colliders.SetTransform(spinningObstacle, obstacle->Position, obstacle->Rotation + obstacleSpinSpeed);
+}
+
+void UpdateBoids()
 {
-    static std::random_device rd;
-    static std::mt19937 engine(rd());
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(engine);
+    if (compactBits == 16)
+        Compact16.Update();
+    else if (compactBits == 32)
+        Compact32.Update();
+    else
+        Simulation.Update();
 }
 
-void CreateRandomBoids(size_t count)
+void CreateWorld()
 {
-    for (size_t i = 0; i < count; i++)
+    Simulation.Settings.worldWidth = windowWidth;
+    Simulation.Settings.worldHeight = windowHeight;
+    Simulation.Settings.neighborMode = neighborMode;
+    Simulation.Settings.topologicalNeighbors = topologicalNeighbors;
+    Simulation.Colliders = &Colliders;
+
+    // Compact mode generates packed boids directly, so no float copy is ever resident.
+    // Analytics holds 16 bytes per boid, so there it is only attached when --metrics asks for it.
+    if (compactBits == 16)
+    {
+        Compact16.Settings = Simulation.Settings;
+        Compact16.Colliders = &Colliders;
+        Compact16.Analytics = metricsPath.empty() ? nullptr : &Analytics;
+        Compact16.CreateRandomBoids(boidCount);
+    }
+    else if (compactBits == 32)
     {
-        Boid boid;
-        boid.id = i;
-        boid.position = Vec2(randomFloat(0, windowWidth), randomFloat(0, windowHeight));
-        // Start with an initial velocity (you can also use a random unit vector)
-        boid.velocity = Vec2(randomFloat(-1.f, 1.f), randomFloat(-1.f, 1.f));
-        boid.velocity.Normalize();
-        // Optionally initialize desiredDirection if still used elsewhere
-        boid.desiredDirection = boid.velocity;
-        Boids.push_back(boid);
+        Compact32.Settings = Simulation.Settings;
+        Compact32.Colliders = &Colliders;
+        Compact32.Analytics = metricsPath.empty() ? nullptr : &Analytics;
+        Compact32.CreateRandomBoids(boidCount);
     }
+    else
+    {
+        Simulation.Analytics = &Analytics;
+        Simulation.CreateRandomBoids(boidCount);
+    }
+
+    Collider worldBorder = Collider::Rectangle(0, 0, windowWidth-1, windowHeight-1);
+    worldBorder.IsHollow = true;
+    worldBorder.IsInvisible = true;
+    
+    Colliders.Add(worldBorder);
+    spinningObstacle = Colliders.Add(Collider::Rectangle(300, 300, 50, 50));
+
+    if (!metricsPath.empty() && !Analytics.OpenCsv(metricsPath))
+        SDL_Log("Couldn't open metrics file %s", metricsPath.c_str());
 }
 
-void UpdateBoid(Boid &boid)
+// Usage: Boids [--boids <count>] [--capture <directory>] [--frames <count>] [--raw] [--no-drop]
+//              [--compact 16|32] [--compact-report [ticks]] [--metrics <csv>] [--topological [k]]
+//              [--ensemble <sweep file>] [--summary <csv>]
+//
+// --capture simulates as fast as it can and drops ticks the encoders can't keep up with, so by default the
+// output is not one frame per tick: frames are numbered without gaps and the missing ticks are listed in
+// dropped_ticks.txt. Add --no-drop for a sequence that plays back at the simulation's rate.
+void ParseArguments(int argc, char *argv[])
 {
-    Vec2 separationForce;
-    Vec2 alignmentForce;
-    Vec2 cohesionForce;
-    Vec2 obstacleForce;
-    int neighborCount = 0;
-
-    // Process neighbors for separation, alignment, and cohesion forces
-    for (Boid &other : Boids)
+    for (int i = 1; i < argc; i++)
     {
-        if (boid == other)
-            continue;
+        std::string arg = argv[i];
 
-        Vec2 diff = boid.position - other.position;
-        float distance = diff.Magnitude();
-
-        if (distance > 0 && distance <= boidViewRange)
+        if (arg == "--boids" && i + 1 < argc)
+        {
+            boidCount = SDL_atoi(argv[++i]);
+        }
+        else if (arg == "--capture" && i + 1 < argc)
+        {
+            runMode = RunMode::Capture;
+            captureDirectory = argv[++i];
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            captureFrameLimit = SDL_atoi(argv[++i]);
+        }
+        else if (arg == "--raw")
         {
-            float angle = Vec2::AngleBetween(boid.velocity.Normalized(), diff.Normalized());
-            if (angle <= boidViewFOV / 2.0f)
+            captureFormat = CaptureFormat::Raw;
+        }
+        else if (arg == "--no-drop")
+        {
+            captureBlockWhenFull = true;
+        }
+        else if (arg == "--compact" && i + 1 < argc)
+        {
+            compactBits = SDL_atoi(argv[++i]);
+            if (compactBits != 16 && compactBits != 32)
             {
-                separationForce = separationForce + (diff.Normalized() / distance);
-                alignmentForce = alignmentForce + other.velocity;
-                cohesionForce = cohesionForce + other.position;
-                neighborCount++;
+                SDL_Log("--compact expects 16 or 32, running float state");
+                compactBits = 0;
             }
         }
-    }
-
-    if (neighborCount > 0)
-    {
-        separationForce = separationForce / static_cast<float>(neighborCount);
-        alignmentForce = alignmentForce / static_cast<float>(neighborCount);
-        cohesionForce = (cohesionForce / static_cast<float>(neighborCount)) - boid.position;
-
-        // For separation we keep the distance effect
-        separationForce = separationForce * boidSeparationStrength;
-
-        if (alignmentForce.Magnitude() > 0)
+        else if (arg == "--topological")
+        {
+            neighborMode = NeighborMode::Topological;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                topologicalNeighbors = SDL_atoi(argv[++i]);
+            if (topologicalNeighbors < 1)
+            {
+                SDL_Log("--topological expects k of at least 1, using 1");
+                topologicalNeighbors = 1;
+            }
+        }
+        else if (arg == "--ensemble" && i + 1 < argc)
+        {
+            runMode = RunMode::Ensemble;
+            ensembleSpecPath = argv[++i];
+        }
+        else if (arg == "--summary" && i + 1 < argc)
         {
-            alignmentForce.Normalize();
-            alignmentForce = alignmentForce * boidAlignmentStrength;
+            ensembleSummaryPath = argv[++i];
         }
-        if (cohesionForce.Magnitude() > 0)
+        else if (arg == "--metrics" && i + 1 < argc)
         {
-            cohesionForce.Normalize();
-            cohesionForce = cohesionForce * boidCohesionStrength;
+            metricsPath = argv[++i];
+        }
+        else if (arg == "--compact-report")
+        {
+            runMode = RunMode::CompactReport;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                compactReportTicks = SDL_atoi(argv[++i]);
+        }
+        else
+        {
+            SDL_Log("Ignoring unknown argument: %s", argv[i]);
         }
     }
 
-    // Process obstacle avoidance via raycasting
-    std::vector<RayHit> hits;
-    // Using a maxDistance (e.g., 200) and a ray count (e.g., 8) for your FOV rays
-    Physics2D::RaycastMulti(Colliders, Physics2D::CreateFOVRays(boid.position, boid.velocity, 180, 200, 8), hits);
-    //DrawRays(hits);
+    // The packed kernel only has metric neighbors, and the report compares against it.
+    if ((compactBits != 0 || runMode == RunMode::CompactReport) && neighborMode == NeighborMode::Topological)
+    {
+        SDL_Log("--topological is ignored with %s, using metric neighbors", runMode == RunMode::CompactReport ? "--compact-report" : "--compact");
+        neighborMode = NeighborMode::Metric;
+    }
+}
 
-    int hitCount = 0;
-    for (RayHit &hit : hits)
+SDL_AppResult InitHeadless()
+{
+    if (!SDL_Init(0))
     {
-        if (!hit.hit)
-            continue;
-
-        // Determine how close the obstacle is relative to the ray's max distance.
-        float t = hit.distance / hit.ray.maxDistance;  // 0 when very close, 1 when at max distance
-        // Use a quadratic falloff so that the avoidance force increases more sharply as you get closer.
-        float falloff = (1.0f - t) * (1.0f - t);
-
-        // Calculate an avoidance direction that steers away from the obstacle.
-        Vec2 avoidanceDir = boid.position - hit.point;
-        if (avoidanceDir.Magnitude() > 1e-6f)
-            avoidanceDir.Normalize();
-
-        // Add the weighted avoidance direction.
-        obstacleForce = obstacleForce + (avoidanceDir * falloff);
-        hitCount++;
+        SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
     }
 
-    if (hitCount > 0)
+    captureSurface = SDL_CreateSurface(windowWidth, windowHeight, SDL_PIXELFORMAT_RGBA32);
+    if (!captureSurface)
     {
-        obstacleForce = obstacleForce / static_cast<float>(hitCount);
-        obstacleForce = obstacleForce * boidObstacleAvoidStrength;
+        SDL_Log("Couldn't create capture surface: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
     }
 
-    // If the computed obstacle force is nearly zero, pick a random avoidance direction.
-    // This helps when all rays return too-similar (or weak) data, so the boid can choose a direction.
-    if (obstacleForce.Magnitude() < 1e-3f)
+    renderer = SDL_CreateSoftwareRenderer(captureSurface);
+    if (!renderer)
     {
-        float randomAngle = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f * M_PI;
-        obstacleForce = Vec2(std::cos(randomAngle), std::sin(randomAngle)) * boidObstacleAvoidStrength;
+        SDL_Log("Couldn't create software renderer: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
     }
 
-    // Compute total acceleration from all steering forces.
-    Vec2 acceleration = separationForce + alignmentForce + cohesionForce + obstacleForce;
+    boidTexture = IMG_LoadTexture(renderer, "assets/cursor-pointing-up.svg");
+    if (!boidTexture)
+    {
+        SDL_Log("Could not load SVG: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
 
-    // Add constant forward acceleration if below max speed.
-    const float boidForwardAccel = 0.5f;  // Adjust as needed.
-    float currentSpeed = boid.velocity.Magnitude();
-    if (currentSpeed > 1e-6f && currentSpeed < boidMaxSpeed)
+    // Keep one core for the simulation; the rest encode.
+    int workerCount = SDL_max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    Capture.BlockWhenFull = captureBlockWhenFull;
+    if (!Capture.Start(captureDirectory, captureFormat, windowWidth, windowHeight, workerCount * captureBuffersPerWorker, workerCount))
     {
-        acceleration = acceleration + boid.velocity.Normalized() * boidForwardAccel;
+        SDL_Log("Couldn't start frame capture in %s", captureDirectory.c_str());
+        return SDL_APP_FAILURE;
     }
 
-    // Update velocity and clamp to boidMaxSpeed.
-    boid.velocity = boid.velocity + acceleration * boidAcceleration;
-    if (boid.velocity.Magnitude() > boidMaxSpeed)
-        boid.velocity.SetLength(boidMaxSpeed);
+    SDL_Log("Capturing %d frames to %s with %d encoder threads", captureFrameLimit, captureDirectory.c_str(), workerCount);
 
-    boid.position = boid.position + boid.velocity;
+    CreateWorld();
 
-    // Wrap around screen boundaries.
-    if (boid.position.x < 0) boid.position.x = windowWidth;
-    else if (boid.position.x > windowWidth) boid.position.x = 0;
+    return SDL_APP_CONTINUE;
+}
 
-    if (boid.position.y < 0) boid.position.y = windowHeight;
-    else if (boid.position.y > windowHeight) boid.position.y = 0;
+void LogMetricMeans(const char *name, const char *run, const MetricMeans &means)
+{
+    SDL_Log("%s: %s flocks %.2f, largest %.3f, polarization %.3f, nearest neighbor %.2f px",
+        name, run, means.flockCount, means.largestFlockFraction, means.polarization, means.nearestNeighborDistance);
 }
 
-void UpdateBoids()
+void LogCompactReport(const char *name, const CompactReport &report)
 {
-    for (Boid &boid : Boids)
+    // Resident memory per boid as the app actually runs: float mode always keeps analytics attached,
+    // compact mode only with --metrics.
+    size_t analyticsBytes = FlockAnalytics::BytesPerBoid();
+    size_t floatBytes = report.floatBytesPerBoid + analyticsBytes;
+    size_t packedBytes = report.bytesPerBoid + (metricsPath.empty() ? 0 : analyticsBytes);
+
+    SDL_Log("%s: state %zu bytes/boid (float %zu), resident %zu bytes/boid (float %zu incl. %zu analytics, %.1f%%), %.2f MB for %d boids",
+        name, report.bytesPerBoid, report.floatBytesPerBoid, packedBytes, floatBytes, analyticsBytes,
+        100.0 * packedBytes / floatBytes, packedBytes * static_cast<double>(boidCount) / (1024.0 * 1024.0), boidCount);
+    SDL_Log("%s: per-tick error over %d ticks: position mean %.5f max %.5f px, heading mean %.4f deg, speed mean %.5f",
+        name, report.ticks, report.meanPositionError, report.maxPositionError, report.meanHeadingError, report.meanSpeedError);
+    SDL_Log("%s: free run over %d ticks:", name, report.freeRunTicks);
+    LogMetricMeans(name, "float ", report.floatRun);
+    LogMetricMeans(name, "packed", report.packedRun);
+}
+
+// Compares one tick of packed state against one tick of float state from the same starting point,
+// then the flock statistics of both left to run freely.
+SDL_AppResult RunCompactReport()
+{
+    // The report measures against the float flock and packs its own copies.
+    compactBits = 0;
+    CreateWorld();
+
+    // Let flocks form first so neighbor interactions are part of what gets measured.
+    for (int tick = 0; tick < compactReportWarmupTicks; tick++)
+    {
+        MoveColliders();
+        Simulation.Update();
+    }
+
+    LogCompactReport("16-bit", CompactFlock<uint16_t>::Measure(Simulation, compactReportTicks, compactFreeRunTicks));
+    LogCompactReport("32-bit", CompactFlock<uint32_t>::Measure(Simulation, compactReportTicks, compactFreeRunTicks));
+
+    return SDL_APP_SUCCESS;
+}
+
+// Runs a whole parameter sweep headless and writes the summary table; no window is created.
+SDL_AppResult RunEnsemble()
+{
+    Ensemble ensemble;
+    std::string error;
+    if (!ensemble.Load(ensembleSpecPath, error))
+    {
+        SDL_Log("Couldn't load sweep: %s", error.c_str());
+        return SDL_APP_FAILURE;
+    }
+
+    SDL_Log("Running %d worlds (%d parameter sets x %d seeds) of %d boids for %d ticks",
+        ensemble.WorldCount(), ensemble.ParameterSetCount(), ensemble.Seeds, ensemble.BoidCount, ensemble.Ticks);
+
+    auto t0 = chrono::steady_clock::now();
+    ensemble.Run();
+    auto t1 = chrono::steady_clock::now();
+    chrono::duration<double> elapsedTime = t1 - t0;
+
+    SDL_Log("Finished in %.2f s (%zu steals)", elapsedTime.count(), ensemble.StealCount());
+
+    if (!ensemble.WriteSummary(ensembleSummaryPath))
     {
-        UpdateBoid(boid);
+        SDL_Log("Couldn't write summary to %s", ensembleSummaryPath.c_str());
+        return SDL_APP_FAILURE;
     }
+
+    SDL_Log("Summary written to %s", ensembleSummaryPath.c_str());
+    return SDL_APP_SUCCESS;
 }
 
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
     SDL_SetAppMetadata("Boids", "1.0", "boids");
 
+    ParseArguments(argc, argv);
+
+    if (runMode == RunMode::CompactReport)
+        return RunCompactReport();
+
+    if (runMode == RunMode::Ensemble)
+        return RunEnsemble();
+
+    if (runMode == RunMode::Capture)
+        return InitHeadless();
+
     if (!SDL_Init(SDL_INIT_VIDEO))
     {
         SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
@@ -288,18 +483,51 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
 
-    CreateRandomBoids(initialBoidCount);
-
-    Collider worldBorder = Collider::Rectangle(0, 0, windowWidth-1, windowHeight-1);
-    worldBorder.IsHollow = true;
-    worldBorder.IsInvisible = true;
-    
-    Colliders.push_back(worldBorder);
-    Colliders.push_back(Collider::Rectangle(300, 300, 50, 50));
+    CreateWorld();
 
     return SDL_APP_CONTINUE;
 }
 
+// Left drag moves a collider. Right click removes the collider under the cursor, or adds a box if there is none.
+void HandleEditorEvent(SDL_Event event)
+{
+    SDL_ConvertEventToRenderCoordinates(renderer, &event);
+
+    if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN)
+    {
+        Vec2 point = Vec2(event.button.x, event.button.y);
+        int picked = Colliders.Pick(point);
+
+        if (event.button.button == SDL_BUTTON_LEFT && picked != -1)
+        {
+            draggedCollider = picked;
+            dragOffset = Colliders.Get(picked)->Position - point;
+        }
+        else if (event.button.button == SDL_BUTTON_RIGHT)
+        {
+            if (picked != -1)
+            {
+                Colliders.Remove(picked);
+                if (picked == spinningObstacle)
+                    spinningObstacle = -1;
+                if (picked == draggedCollider)
+                    draggedCollider = -1;
+            }
+            else
+                Colliders.Add(Collider::Rectangle(point.x - editorBoxSize / 2, point.y - editorBoxSize / 2, editorBoxSize, editorBoxSize));
+        }
+    }
+    else if (event.type == SDL_EVENT_MOUSE_MOTION && draggedCollider != -1)
+    {
+        if (Collider *collider = Colliders.Get(draggedCollider))
+            Colliders.SetTransform(draggedCollider, Vec2(event.motion.x, event.motion.y) + dragOffset, collider->Rotation);
+    }
+    else if (event.type == SDL_EVENT_MOUSE_BUTTON_UP && event.button.button == SDL_BUTTON_LEFT)
+    {
+        draggedCollider = -1;
+    }
+}
+
 SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 {
     if (event->type == SDL_EVENT_QUIT)
@@ -307,6 +535,13 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
         return SDL_APP_SUCCESS;
     }
 
+    if (runMode != RunMode::Window)
+        return SDL_APP_CONTINUE;
+
+    ImGui_ImplSDL3_ProcessEvent(event);
+    if (!ImGui::GetIO().WantCaptureMouse)
+        HandleEditorEvent(*event);
+
     return SDL_APP_CONTINUE;
 }
 
@@ -324,6 +559,7 @@ void FixedUpdate()
 
     // Render your game content using OpenGL commands
     // For example:
+    MoveColliders();
     UpdateBoids();
     DrawBoids();
     DrawColliders();
@@ -337,6 +573,30 @@ void FixedUpdate()
     // Create the control panel
     ImGui::Begin("Control Panel");
     ImGui::Text("Adjust your variables:");
+
+    if (compactBits == 0)
+    {
+        bool topological = Simulation.Settings.neighborMode == NeighborMode::Topological;
+        if (ImGui::Checkbox("Topological neighbors", &topological))
+            Simulation.Settings.neighborMode = topological ? NeighborMode::Topological : NeighborMode::Metric;
+        ImGui::SliderInt("Neighbors (k)", &Simulation.Settings.topologicalNeighbors, 1, 32);
+    }
+    else
+        ImGui::Text("Compact state uses metric neighbors");
+
+    const FlockMetrics &metrics = Analytics.Latest();
+    ImGui::Separator();
+    if (compactBits != 0 && metricsPath.empty())
+        ImGui::Text("Flock health is off in compact mode (enable with --metrics)");
+    else
+    {
+        ImGui::Text("Flock health (tick %ld)", metrics.tick);
+        ImGui::Text("Flocks: %d", metrics.flockCount);
+        ImGui::Text("Largest flock: %d / %d", metrics.largestFlock, metrics.boidCount);
+        ImGui::Text("Polarization: %.3f", metrics.polarization);
+        ImGui::Text("Nearest neighbor: %.1f px", metrics.meanNearestNeighborDistance);
+        ImGui::Text("Neighbors per boid: %.1f", metrics.meanNeighborCount);
+    }
     ImGui::End();
     
     // Render ImGui on top of your scene
@@ -348,8 +608,44 @@ void FixedUpdate()
     SDL_RenderPresent(renderer);
 }
 
+void LogCaptureStats()
+{
+    SDL_Log("Capture: %zu submitted, %zu written, %zu queued, %zu dropped",
+        Capture.FramesSubmitted(), Capture.FramesWritten(), Capture.FramesQueued(), Capture.FramesDropped());
+}
+
+// Runs one tick offscreen and hands the frame to the encoder threads.
+// By default the simulation never waits on the encoders: if they fall behind, frames are dropped and
+// their ticks recorded. With --no-drop it waits for a free buffer instead, so every tick is written.
+SDL_AppResult CaptureUpdate()
+{
+    MoveColliders();
+    UpdateBoids();
+
+    SDL_SetRenderDrawColorFloat(renderer, 1, 1, 1, SDL_ALPHA_OPAQUE_FLOAT);
+    SDL_RenderClear(renderer);
+    DrawBoids();
+    DrawColliders();
+    SDL_FlushRenderer(renderer);
+
+    if (SDL_LockSurface(captureSurface))
+    {
+        Capture.Submit(captureSurface->pixels, captureSurface->pitch);
+        SDL_UnlockSurface(captureSurface);
+    }
+
+    captureFrameCount++;
+    if (captureFrameCount % tickRate == 0)
+        LogCaptureStats();
+
+    return captureFrameCount >= captureFrameLimit ? SDL_APP_SUCCESS : SDL_APP_CONTINUE;
+}
+
 SDL_AppResult SDL_AppIterate(void *appstate)
 {
+    if (runMode == RunMode::Capture)
+        return CaptureUpdate();
+
     auto t0 = chrono::high_resolution_clock::now();
     FixedUpdate();
     auto t1 = chrono::high_resolution_clock::now();
@@ -361,9 +657,38 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 
 void SDL_AppQuit(void *appstate, SDL_AppResult result)
 {
+    Analytics.CloseCsv();
+
+    if (runMode == RunMode::CompactReport || runMode == RunMode::Ensemble)
+    {
+        SDL_Quit();
+        return;
+    }
+
+    if (runMode == RunMode::Capture)
+    {
+        Capture.Stop();
+        LogCaptureStats();
+        size_t submitted = Capture.FramesSubmitted();
+        size_t dropped = Capture.FramesDropped();
+        if (dropped > 0 && dropped >= captureDropWarningRatio * submitted)
+        {
+            SDL_Log("WARNING: %zu of %zu ticks (%.0f%%) were dropped because the encoders fell behind.",
+                dropped, submitted, 100.0 * dropped / submitted);
+            SDL_Log("WARNING: the frames in %s are not one per tick and will play back too fast; rerun with --no-drop.",
+                captureDirectory.c_str());
+        }
+        if (dropped > 0)
+            SDL_Log("Dropped ticks listed in %s/dropped_ticks.txt", captureDirectory.c_str());
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(captureSurface);
+        SDL_Quit();
+        return;
+    }
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
     SDL_DestroyWindow(window);
     SDL_Quit();
-}
+}
\ No newline at end of file